@@ -0,0 +1,889 @@
+// helpers/protopirate_capture_index.c
+#include "protopirate_capture_index.h"
+#include "protopirate_storage.h"
+#include <toolbox/stream/file_stream.h>
+#include <toolbox/stream/stream.h>
+#include <toolbox/dir_walk.h>
+
+#define TAG "ProtoPirateCaptureIndex"
+
+#define INDEX_MAGIC    0x58495050 // "PPIX"
+#define INDEX_VERSION  1
+#define INDEX_TMP_PATH EXT_PATH("subghz/protopirate/captures.tmp")
+
+// Compact the file on load once tombstones outnumber live records
+#define INDEX_COMPACT_MIN_TOMBSTONES 32
+#define INDEX_READ_BATCH             8
+
+// Positions into the time-sorted entry list are kept as uint16 to halve the
+// lookup arrays, which bounds the browser at this many captures
+#define INDEX_MAX_ENTRIES   UINT16_MAX
+#define INDEX_MAX_PROTOCOLS 32
+#define INDEX_FREQUENCY_STEP 10000
+
+typedef struct
+{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t record_size;
+} ProtoPirateCaptureIndexHeader;
+
+// In-RAM view of the index: enough to sort, filter and find the record on disk
+typedef struct
+{
+    uint32_t timestamp;
+    uint32_t serial;
+    uint32_t record;
+    uint32_t frequency; // In INDEX_FREQUENCY_STEP units
+    uint8_t btn;
+    uint8_t protocol_id;
+    bool has_serial; // serial is 0 otherwise and must not match a prefix
+} ProtoPirateCaptureIndexEntry;
+
+static ProtoPirateCaptureIndexEntry *g_entries = NULL;
+static uint32_t g_entry_count = 0;
+static uint32_t g_entry_capacity = 0;
+static bool g_loaded = false;
+
+static char g_protocols[INDEX_MAX_PROTOCOLS][sizeof(((ProtoPirateCaptureInfo *)0)->protocol)];
+static uint8_t g_protocol_count = 0;
+
+// Lookup structures over g_entries, rebuilt lazily after the list changes:
+// positions grouped per protocol (each bucket in time order) and positions
+// sorted by serial for prefix range searches.
+static uint16_t *g_by_protocol = NULL;
+static uint16_t g_bucket_start[INDEX_MAX_PROTOCOLS];
+static uint16_t g_bucket_count[INDEX_MAX_PROTOCOLS];
+static uint16_t *g_by_serial = NULL;
+static bool g_lookup_dirty = true;
+
+// Filtered view handed out by get_count/get while a filter is set
+static ProtoPirateCaptureFilter g_filter;
+static bool g_filter_active = false;
+static uint16_t *g_view = NULL;
+static uint32_t g_view_count = 0;
+static bool g_view_dirty = true;
+
+// Read handle kept open while the browser pages through records
+static File *g_reader = NULL;
+
+static uint32_t protopirate_capture_index_offset(uint32_t record)
+{
+    return sizeof(ProtoPirateCaptureIndexHeader) + record * sizeof(ProtoPirateCaptureInfo);
+}
+
+static void protopirate_capture_index_close_reader(void)
+{
+    if (g_reader)
+    {
+        storage_file_close(g_reader);
+        storage_file_free(g_reader);
+        g_reader = NULL;
+        furi_record_close(RECORD_STORAGE);
+    }
+}
+
+static bool protopirate_capture_index_read_header(File *file)
+{
+    ProtoPirateCaptureIndexHeader header;
+    return storage_file_read(file, &header, sizeof(header)) == sizeof(header) &&
+           header.magic == INDEX_MAGIC && header.version == INDEX_VERSION &&
+           header.record_size == sizeof(ProtoPirateCaptureInfo);
+}
+
+static bool protopirate_capture_index_write_header(File *file)
+{
+    ProtoPirateCaptureIndexHeader header = {
+        .magic = INDEX_MAGIC,
+        .version = INDEX_VERSION,
+        .record_size = sizeof(ProtoPirateCaptureInfo),
+    };
+    return storage_file_write(file, &header, sizeof(header)) == sizeof(header);
+}
+
+static int protopirate_capture_index_entry_cmp(const void *a, const void *b)
+{
+    const ProtoPirateCaptureIndexEntry *entry_a = a;
+    const ProtoPirateCaptureIndexEntry *entry_b = b;
+
+    // Newest first; later records win ties since they were saved later
+    if (entry_a->timestamp != entry_b->timestamp)
+    {
+        return entry_a->timestamp < entry_b->timestamp ? 1 : -1;
+    }
+    return entry_a->record < entry_b->record ? 1 : -1;
+}
+
+static uint8_t protopirate_capture_index_intern_protocol(const char *protocol)
+{
+    for (uint8_t i = 0; i < g_protocol_count; i++)
+    {
+        if (strcmp(g_protocols[i], protocol) == 0)
+        {
+            return i;
+        }
+    }
+    if (g_protocol_count == INDEX_MAX_PROTOCOLS)
+    {
+        // Still listed, just not selectable in the protocol filter
+        return PROTOPIRATE_CAPTURE_FILTER_ANY - 1;
+    }
+    strncpy(g_protocols[g_protocol_count], protocol, sizeof(g_protocols[0]) - 1);
+    return g_protocol_count++;
+}
+
+static void protopirate_capture_index_mark_dirty(void)
+{
+    g_lookup_dirty = true;
+    g_view_dirty = true;
+}
+
+static bool protopirate_capture_index_push(const ProtoPirateCaptureInfo *info, uint32_t record)
+{
+    if (g_entry_count >= INDEX_MAX_ENTRIES)
+    {
+        return false;
+    }
+    if (g_entry_count == g_entry_capacity)
+    {
+        g_entry_capacity = g_entry_capacity ? g_entry_capacity * 2 : 64;
+        g_entries = realloc(g_entries, sizeof(ProtoPirateCaptureIndexEntry) * g_entry_capacity);
+    }
+
+    ProtoPirateCaptureIndexEntry *entry = &g_entries[g_entry_count++];
+    entry->timestamp = info->timestamp;
+    entry->record = record;
+    entry->has_serial = (info->flags & ProtoPirateCaptureInfoFlagSerial) != 0;
+    entry->serial = entry->has_serial ? info->serial : 0;
+    entry->frequency = info->frequency / INDEX_FREQUENCY_STEP;
+    entry->btn = (info->flags & ProtoPirateCaptureInfoFlagBtn) ? info->btn :
+                                                                  PROTOPIRATE_CAPTURE_FILTER_ANY;
+    entry->protocol_id = protopirate_capture_index_intern_protocol(info->protocol);
+    protopirate_capture_index_mark_dirty();
+    return true;
+}
+
+static bool protopirate_capture_index_parse_uint(
+    const char *line,
+    const char *key,
+    uint32_t *out)
+{
+    size_t key_len = strlen(key);
+    if (strncmp(line, key, key_len) != 0 || line[key_len] != ':')
+    {
+        return false;
+    }
+    *out = strtoul(line + key_len + 1, NULL, 10);
+    return true;
+}
+
+void protopirate_capture_index_parse_line(ProtoPirateCaptureInfo *info, const FuriString *line)
+{
+    const char *str = furi_string_get_cstr(line);
+    uint32_t value;
+
+    if (strncmp(str, "Protocol:", 9) == 0)
+    {
+        const char *name = str + 9;
+        while (*name == ' ')
+        {
+            name++;
+        }
+        size_t len = strcspn(name, "\r\n");
+        if (len >= sizeof(info->protocol))
+        {
+            len = sizeof(info->protocol) - 1;
+        }
+        memcpy(info->protocol, name, len);
+        info->protocol[len] = '\0';
+    }
+    else if (protopirate_capture_index_parse_uint(str, "Frequency", &info->frequency))
+    {
+        info->flags |= ProtoPirateCaptureInfoFlagFrequency;
+    }
+    else if (protopirate_capture_index_parse_uint(str, "Serial", &info->serial))
+    {
+        info->flags |= ProtoPirateCaptureInfoFlagSerial;
+    }
+    else if (protopirate_capture_index_parse_uint(str, "Btn", &value))
+    {
+        info->btn = value;
+        info->flags |= ProtoPirateCaptureInfoFlagBtn;
+    }
+    else if (protopirate_capture_index_parse_uint(str, "Cnt", &info->cnt))
+    {
+        info->flags |= ProtoPirateCaptureInfoFlagCnt;
+    }
+    else if (protopirate_capture_index_parse_uint(str, "CRC", &value))
+    {
+        info->crc = value;
+        info->flags |= ProtoPirateCaptureInfoFlagCrc;
+    }
+    else if (protopirate_capture_index_parse_uint(str, "Type", &value))
+    {
+        info->type = value;
+        info->flags |= ProtoPirateCaptureInfoFlagType;
+    }
+}
+
+// Rewrite the index without tombstoned records
+static bool protopirate_capture_index_compact(Storage *storage)
+{
+    File *src = storage_file_alloc(storage);
+    File *dst = storage_file_alloc(storage);
+    ProtoPirateCaptureInfo info;
+    bool result = false;
+
+    do
+    {
+        if (!storage_file_open(src, PROTOPIRATE_CAPTURE_INDEX_PATH, FSAM_READ, FSOM_OPEN_EXISTING) ||
+            !protopirate_capture_index_read_header(src))
+        {
+            break;
+        }
+        if (!storage_file_open(dst, INDEX_TMP_PATH, FSAM_WRITE, FSOM_CREATE_ALWAYS) ||
+            !protopirate_capture_index_write_header(dst))
+        {
+            break;
+        }
+
+        result = true;
+        while (storage_file_read(src, &info, sizeof(info)) == sizeof(info))
+        {
+            if (info.flags & ProtoPirateCaptureInfoFlagDeleted)
+            {
+                continue;
+            }
+            if (storage_file_write(dst, &info, sizeof(info)) != sizeof(info))
+            {
+                result = false;
+                break;
+            }
+        }
+    } while (false);
+
+    storage_file_close(src);
+    storage_file_close(dst);
+    storage_file_free(src);
+    storage_file_free(dst);
+
+    if (result)
+    {
+        storage_common_remove(storage, PROTOPIRATE_CAPTURE_INDEX_PATH);
+        result = storage_common_rename(storage, INDEX_TMP_PATH, PROTOPIRATE_CAPTURE_INDEX_PATH) ==
+                 FSE_OK;
+    }
+    else
+    {
+        storage_common_remove(storage, INDEX_TMP_PATH);
+    }
+
+    FURI_LOG_I(TAG, "Compacted index: %s", result ? "OK" : "FAILED");
+    return result;
+}
+
+static bool protopirate_capture_index_read_entries(Storage *storage, uint32_t *out_tombstones)
+{
+    File *file = storage_file_alloc(storage);
+    ProtoPirateCaptureInfo *batch = malloc(sizeof(ProtoPirateCaptureInfo) * INDEX_READ_BATCH);
+    uint32_t record = 0;
+    bool result = false;
+
+    g_entry_count = 0;
+    g_protocol_count = 0;
+    *out_tombstones = 0;
+
+    if (storage_file_open(file, PROTOPIRATE_CAPTURE_INDEX_PATH, FSAM_READ, FSOM_OPEN_EXISTING) &&
+        protopirate_capture_index_read_header(file))
+    {
+        size_t read;
+        while ((read = storage_file_read(
+                    file, batch, sizeof(ProtoPirateCaptureInfo) * INDEX_READ_BATCH)) >=
+               sizeof(ProtoPirateCaptureInfo))
+        {
+            for (size_t i = 0; i < read / sizeof(ProtoPirateCaptureInfo); i++, record++)
+            {
+                if (batch[i].flags & ProtoPirateCaptureInfoFlagDeleted)
+                {
+                    (*out_tombstones)++;
+                }
+                else
+                {
+                    protopirate_capture_index_push(&batch[i], record);
+                }
+            }
+        }
+        result = true;
+    }
+
+    storage_file_close(file);
+    storage_file_free(file);
+    free(batch);
+    return result;
+}
+
+bool protopirate_capture_index_load(void)
+{
+    if (g_loaded)
+    {
+        return true;
+    }
+
+    Storage *storage = furi_record_open(RECORD_STORAGE);
+    uint32_t tombstones = 0;
+    bool result = protopirate_capture_index_read_entries(storage, &tombstones);
+    furi_record_close(RECORD_STORAGE);
+
+    if (!result)
+    {
+        FURI_LOG_I(TAG, "Index missing or invalid, rebuilding");
+        if (!protopirate_capture_index_rebuild())
+        {
+            return false;
+        }
+        storage = furi_record_open(RECORD_STORAGE);
+        result = protopirate_capture_index_read_entries(storage, &tombstones);
+        furi_record_close(RECORD_STORAGE);
+    }
+    else if (tombstones >= INDEX_COMPACT_MIN_TOMBSTONES && tombstones > g_entry_count)
+    {
+        storage = furi_record_open(RECORD_STORAGE);
+        if (protopirate_capture_index_compact(storage))
+        {
+            result = protopirate_capture_index_read_entries(storage, &tombstones);
+        }
+        furi_record_close(RECORD_STORAGE);
+    }
+
+    if (g_entry_count > 1)
+    {
+        qsort(
+            g_entries,
+            g_entry_count,
+            sizeof(ProtoPirateCaptureIndexEntry),
+            protopirate_capture_index_entry_cmp);
+    }
+
+    g_loaded = result;
+    FURI_LOG_I(TAG, "Loaded %lu captures (%lu tombstones)", g_entry_count, tombstones);
+    return result;
+}
+
+void protopirate_capture_index_unload(void)
+{
+    protopirate_capture_index_close_reader();
+    free(g_entries);
+    g_entries = NULL;
+    g_entry_count = 0;
+    g_entry_capacity = 0;
+    g_protocol_count = 0;
+    free(g_by_protocol);
+    free(g_by_serial);
+    free(g_view);
+    g_by_protocol = NULL;
+    g_by_serial = NULL;
+    g_view = NULL;
+    g_view_count = 0;
+    protopirate_capture_index_mark_dirty();
+    g_loaded = false;
+}
+
+void protopirate_capture_filter_reset(ProtoPirateCaptureFilter *filter)
+{
+    furi_assert(filter);
+    filter->protocol[0] = '\0';
+    filter->btn = PROTOPIRATE_CAPTURE_FILTER_ANY;
+    filter->serial_prefix_len = 0;
+    filter->serial_prefix = 0;
+    filter->frequency = 0;
+}
+
+bool protopirate_capture_filter_is_active(const ProtoPirateCaptureFilter *filter)
+{
+    furi_assert(filter);
+    return filter->protocol[0] != '\0' ||
+           filter->btn != PROTOPIRATE_CAPTURE_FILTER_ANY || filter->serial_prefix_len > 0 ||
+           filter->frequency != 0;
+}
+
+static int protopirate_capture_index_serial_cmp(const void *a, const void *b)
+{
+    uint32_t serial_a = g_entries[*(const uint16_t *)a].serial;
+    uint32_t serial_b = g_entries[*(const uint16_t *)b].serial;
+    return (serial_a > serial_b) - (serial_a < serial_b);
+}
+
+static int protopirate_capture_index_position_cmp(const void *a, const void *b)
+{
+    return (int)*(const uint16_t *)a - (int)*(const uint16_t *)b;
+}
+
+static void protopirate_capture_index_build_lookup(void)
+{
+    if (!g_lookup_dirty)
+    {
+        return;
+    }
+
+    free(g_by_protocol);
+    free(g_by_serial);
+    g_by_protocol = malloc(sizeof(uint16_t) * (g_entry_count + 1));
+    g_by_serial = malloc(sizeof(uint16_t) * (g_entry_count + 1));
+
+    // Counting sort into protocol buckets keeps each bucket in time order
+    memset(g_bucket_count, 0, sizeof(g_bucket_count));
+    for (uint32_t i = 0; i < g_entry_count; i++)
+    {
+        if (g_entries[i].protocol_id < INDEX_MAX_PROTOCOLS)
+        {
+            g_bucket_count[g_entries[i].protocol_id]++;
+        }
+    }
+    uint16_t offset = 0;
+    for (uint8_t i = 0; i < INDEX_MAX_PROTOCOLS; i++)
+    {
+        g_bucket_start[i] = offset;
+        offset += g_bucket_count[i];
+    }
+    uint16_t fill[INDEX_MAX_PROTOCOLS];
+    memcpy(fill, g_bucket_start, sizeof(fill));
+    for (uint32_t i = 0; i < g_entry_count; i++)
+    {
+        uint8_t id = g_entries[i].protocol_id;
+        if (id < INDEX_MAX_PROTOCOLS)
+        {
+            g_by_protocol[fill[id]++] = i;
+        }
+        g_by_serial[i] = i;
+    }
+
+    qsort(g_by_serial, g_entry_count, sizeof(uint16_t), protopirate_capture_index_serial_cmp);
+    g_lookup_dirty = false;
+}
+
+// protocol_id is the filter's protocol resolved against the current index
+static bool protopirate_capture_index_matches(
+    const ProtoPirateCaptureIndexEntry *entry,
+    const ProtoPirateCaptureFilter *filter,
+    uint8_t protocol_id)
+{
+    if (protocol_id != PROTOPIRATE_CAPTURE_FILTER_ANY && entry->protocol_id != protocol_id)
+    {
+        return false;
+    }
+    if (filter->btn != PROTOPIRATE_CAPTURE_FILTER_ANY && entry->btn != filter->btn)
+    {
+        return false;
+    }
+    if (filter->frequency && entry->frequency != filter->frequency / INDEX_FREQUENCY_STEP)
+    {
+        return false;
+    }
+    if (filter->serial_prefix_len > 0)
+    {
+        uint8_t shift = (8 - filter->serial_prefix_len) * 4;
+        if (!entry->has_serial || (entry->serial >> shift) != filter->serial_prefix)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// First position in g_by_serial whose serial is >= value
+static uint32_t protopirate_capture_index_serial_lower_bound(uint64_t value)
+{
+    uint32_t low = 0;
+    uint32_t high = g_entry_count;
+    while (low < high)
+    {
+        uint32_t mid = (low + high) / 2;
+        if (g_entries[g_by_serial[mid]].serial < value)
+        {
+            low = mid + 1;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+static void protopirate_capture_index_build_view(void)
+{
+    if (!g_view_dirty)
+    {
+        return;
+    }
+
+    protopirate_capture_index_build_lookup();
+    free(g_view);
+    g_view = malloc(sizeof(uint16_t) * (g_entry_count + 1));
+    g_view_count = 0;
+
+    uint8_t protocol_id = PROTOPIRATE_CAPTURE_FILTER_ANY;
+    bool protocol_found = true;
+    if (g_filter.protocol[0])
+    {
+        protocol_found = false;
+        for (uint8_t i = 0; i < g_protocol_count && !protocol_found; i++)
+        {
+            if (strcmp(g_protocols[i], g_filter.protocol) == 0)
+            {
+                protocol_id = i;
+                protocol_found = true;
+            }
+        }
+    }
+
+    if (!protocol_found)
+    {
+        // No capture of that protocol is indexed any more
+    }
+    else if (g_filter.serial_prefix_len > 0)
+    {
+        // A hex prefix is a contiguous serial range in the sorted array
+        uint8_t shift = (8 - g_filter.serial_prefix_len) * 4;
+        uint64_t low = (uint64_t)g_filter.serial_prefix << shift;
+        uint64_t high = ((uint64_t)g_filter.serial_prefix + 1) << shift;
+        uint32_t end = protopirate_capture_index_serial_lower_bound(high);
+        for (uint32_t i = protopirate_capture_index_serial_lower_bound(low); i < end; i++)
+        {
+            // Serial-less captures sort as 0; matches() leaves them out
+            if (protopirate_capture_index_matches(
+                    &g_entries[g_by_serial[i]], &g_filter, protocol_id))
+            {
+                g_view[g_view_count++] = g_by_serial[i];
+            }
+        }
+        // Back to newest-first order for display
+        qsort(g_view, g_view_count, sizeof(uint16_t), protopirate_capture_index_position_cmp);
+    }
+    else if (protocol_id < INDEX_MAX_PROTOCOLS)
+    {
+        const uint16_t *bucket = &g_by_protocol[g_bucket_start[protocol_id]];
+        for (uint32_t i = 0; i < g_bucket_count[protocol_id]; i++)
+        {
+            if (protopirate_capture_index_matches(&g_entries[bucket[i]], &g_filter, protocol_id))
+            {
+                g_view[g_view_count++] = bucket[i];
+            }
+        }
+    }
+    else
+    {
+        for (uint32_t i = 0; i < g_entry_count; i++)
+        {
+            if (protopirate_capture_index_matches(&g_entries[i], &g_filter, protocol_id))
+            {
+                g_view[g_view_count++] = i;
+            }
+        }
+    }
+
+    g_view_dirty = false;
+    FURI_LOG_D(TAG, "Filter matched %lu of %lu captures", g_view_count, g_entry_count);
+}
+
+void protopirate_capture_index_set_filter(const ProtoPirateCaptureFilter *filter)
+{
+    g_filter_active = filter && protopirate_capture_filter_is_active(filter);
+    if (g_filter_active)
+    {
+        g_filter = *filter;
+    }
+    g_view_dirty = true;
+}
+
+uint8_t protopirate_capture_index_get_protocol_count(void)
+{
+    return g_protocol_count;
+}
+
+const char *protopirate_capture_index_get_protocol_name(uint8_t protocol_id)
+{
+    return protocol_id < g_protocol_count ? g_protocols[protocol_id] : NULL;
+}
+
+uint8_t protopirate_capture_index_get_buttons(uint8_t *out, uint8_t max)
+{
+    furi_assert(out);
+    uint32_t seen[256 / 32] = {0};
+    for (uint32_t i = 0; i < g_entry_count; i++)
+    {
+        seen[g_entries[i].btn / 32] |= 1UL << (g_entries[i].btn % 32);
+    }
+
+    uint8_t count = 0;
+    for (uint16_t btn = 0; btn < PROTOPIRATE_CAPTURE_FILTER_ANY && count < max; btn++)
+    {
+        if (seen[btn / 32] & (1UL << (btn % 32)))
+        {
+            out[count++] = btn;
+        }
+    }
+    return count;
+}
+
+uint32_t protopirate_capture_index_get_count(void)
+{
+    if (g_filter_active)
+    {
+        protopirate_capture_index_build_view();
+        return g_view_count;
+    }
+    return g_entry_count;
+}
+
+bool protopirate_capture_index_get(uint32_t index, ProtoPirateCaptureInfo *out_info)
+{
+    furi_assert(out_info);
+    if (g_filter_active)
+    {
+        protopirate_capture_index_build_view();
+        if (index >= g_view_count)
+        {
+            return false;
+        }
+        index = g_view[index];
+    }
+    if (index >= g_entry_count)
+    {
+        return false;
+    }
+
+    if (!g_reader)
+    {
+        Storage *storage = furi_record_open(RECORD_STORAGE);
+        g_reader = storage_file_alloc(storage);
+        if (!storage_file_open(
+                g_reader, PROTOPIRATE_CAPTURE_INDEX_PATH, FSAM_READ, FSOM_OPEN_EXISTING))
+        {
+            storage_file_free(g_reader);
+            g_reader = NULL;
+            furi_record_close(RECORD_STORAGE);
+            return false;
+        }
+    }
+
+    return storage_file_seek(
+               g_reader, protopirate_capture_index_offset(g_entries[index].record), true) &&
+           storage_file_read(g_reader, out_info, sizeof(ProtoPirateCaptureInfo)) ==
+               sizeof(ProtoPirateCaptureInfo);
+}
+
+bool protopirate_capture_index_append(const ProtoPirateCaptureInfo *info)
+{
+    furi_assert(info);
+    protopirate_capture_index_close_reader();
+
+    Storage *storage = furi_record_open(RECORD_STORAGE);
+    bool exists = storage_file_exists(storage, PROTOPIRATE_CAPTURE_INDEX_PATH);
+    furi_record_close(RECORD_STORAGE);
+
+    // Without an index the rebuild walks the folder, which already includes
+    // the capture that was just written
+    if (!exists)
+    {
+        bool was_loaded = g_loaded;
+        protopirate_capture_index_unload();
+        bool result = protopirate_capture_index_rebuild();
+        if (was_loaded)
+        {
+            protopirate_capture_index_load();
+        }
+        return result;
+    }
+
+    storage = furi_record_open(RECORD_STORAGE);
+    File *file = storage_file_alloc(storage);
+    bool result = false;
+    uint32_t record = 0;
+
+    do
+    {
+        if (!storage_file_open(
+                file, PROTOPIRATE_CAPTURE_INDEX_PATH, FSAM_READ_WRITE, FSOM_OPEN_EXISTING))
+        {
+            FURI_LOG_E(TAG, "Failed to open index");
+            break;
+        }
+
+        uint64_t size = storage_file_size(file);
+        if (size < sizeof(ProtoPirateCaptureIndexHeader))
+        {
+            break;
+        }
+        record = (size - sizeof(ProtoPirateCaptureIndexHeader)) / sizeof(ProtoPirateCaptureInfo);
+
+        if (!storage_file_seek(file, protopirate_capture_index_offset(record), true) ||
+            storage_file_write(file, info, sizeof(ProtoPirateCaptureInfo)) !=
+                sizeof(ProtoPirateCaptureInfo))
+        {
+            FURI_LOG_E(TAG, "Failed to append record");
+            break;
+        }
+
+        result = true;
+    } while (false);
+
+    storage_file_close(file);
+    storage_file_free(file);
+    furi_record_close(RECORD_STORAGE);
+
+    // Keep the in-RAM view sorted without a full reload
+    if (result && g_loaded && protopirate_capture_index_push(info, record))
+    {
+        ProtoPirateCaptureIndexEntry entry = g_entries[g_entry_count - 1];
+        uint32_t pos = g_entry_count - 1;
+        while (pos > 0 && protopirate_capture_index_entry_cmp(&g_entries[pos - 1], &entry) > 0)
+        {
+            g_entries[pos] = g_entries[pos - 1];
+            pos--;
+        }
+        g_entries[pos] = entry;
+    }
+
+    return result;
+}
+
+bool protopirate_capture_index_remove(const char *relative_path)
+{
+    furi_assert(relative_path);
+    protopirate_capture_index_close_reader();
+
+    Storage *storage = furi_record_open(RECORD_STORAGE);
+    File *file = storage_file_alloc(storage);
+    ProtoPirateCaptureInfo info;
+    uint32_t record = 0;
+    bool result = false;
+
+    if (storage_file_open(file, PROTOPIRATE_CAPTURE_INDEX_PATH, FSAM_READ_WRITE, FSOM_OPEN_EXISTING) &&
+        protopirate_capture_index_read_header(file))
+    {
+        while (storage_file_read(file, &info, sizeof(info)) == sizeof(info))
+        {
+            if (!(info.flags & ProtoPirateCaptureInfoFlagDeleted) &&
+                strcmp(info.path, relative_path) == 0)
+            {
+                info.flags |= ProtoPirateCaptureInfoFlagDeleted;
+                result = storage_file_seek(file, protopirate_capture_index_offset(record), true) &&
+                         storage_file_write(file, &info, sizeof(info)) == sizeof(info);
+                break;
+            }
+            record++;
+        }
+    }
+
+    storage_file_close(file);
+    storage_file_free(file);
+    furi_record_close(RECORD_STORAGE);
+
+    if (result && g_loaded)
+    {
+        for (uint32_t i = 0; i < g_entry_count; i++)
+        {
+            if (g_entries[i].record == record)
+            {
+                memmove(
+                    &g_entries[i],
+                    &g_entries[i + 1],
+                    sizeof(ProtoPirateCaptureIndexEntry) * (g_entry_count - i - 1));
+                g_entry_count--;
+                protopirate_capture_index_mark_dirty();
+                break;
+            }
+        }
+    }
+
+    FURI_LOG_D(TAG, "Tombstone %s: %s", relative_path, result ? "OK" : "NOT FOUND");
+    return result;
+}
+
+bool protopirate_capture_index_rebuild(void)
+{
+    protopirate_capture_index_close_reader();
+
+    Storage *storage = furi_record_open(RECORD_STORAGE);
+    if (!storage_dir_exists(storage, PROTOPIRATE_APP_FOLDER))
+    {
+        storage_simply_mkdir(storage, PROTOPIRATE_APP_FOLDER);
+    }
+
+    File *index_file = storage_file_alloc(storage);
+    Stream *capture = file_stream_alloc(storage);
+    DirWalk *dir_walk = dir_walk_alloc(storage);
+    dir_walk_set_recursive(dir_walk, true);
+    FuriString *path = furi_string_alloc();
+    FuriString *line = furi_string_alloc();
+    const size_t folder_len = strlen(PROTOPIRATE_APP_FOLDER) + 1;
+    ProtoPirateCaptureInfo info;
+    FileInfo file_info;
+    uint32_t count = 0;
+    bool result = false;
+
+    do
+    {
+        if (!storage_file_open(
+                index_file, PROTOPIRATE_CAPTURE_INDEX_PATH, FSAM_WRITE, FSOM_CREATE_ALWAYS) ||
+            !protopirate_capture_index_write_header(index_file))
+        {
+            FURI_LOG_E(TAG, "Failed to create index");
+            break;
+        }
+
+        result = true;
+        if (!dir_walk_open(dir_walk, PROTOPIRATE_APP_FOLDER))
+        {
+            break;
+        }
+
+        while (dir_walk_read(dir_walk, path, &file_info) == DirWalkOK)
+        {
+            if (file_info_is_dir(&file_info) ||
+                !strstr(furi_string_get_cstr(path), PROTOPIRATE_APP_EXTENSION) ||
+                furi_string_size(path) <= folder_len)
+            {
+                continue;
+            }
+
+            memset(&info, 0, sizeof(info));
+            strncpy(info.path, furi_string_get_cstr(path) + folder_len, sizeof(info.path) - 1);
+            storage_common_timestamp(storage, furi_string_get_cstr(path), &info.timestamp);
+
+            if (file_stream_open(capture, furi_string_get_cstr(path), FSAM_READ, FSOM_OPEN_EXISTING))
+            {
+                while (stream_read_line(capture, line))
+                {
+                    protopirate_capture_index_parse_line(&info, line);
+                }
+            }
+            file_stream_close(capture);
+
+            if (storage_file_write(index_file, &info, sizeof(info)) != sizeof(info))
+            {
+                result = false;
+                break;
+            }
+            count++;
+        }
+        dir_walk_close(dir_walk);
+    } while (false);
+
+    storage_file_close(index_file);
+    if (!result)
+    {
+        storage_common_remove(storage, PROTOPIRATE_CAPTURE_INDEX_PATH);
+    }
+
+    furi_string_free(line);
+    furi_string_free(path);
+    dir_walk_free(dir_walk);
+    stream_free(capture);
+    storage_file_free(index_file);
+    furi_record_close(RECORD_STORAGE);
+
+    FURI_LOG_I(TAG, "Rebuilt index with %lu captures", count);
+    return result;
+}
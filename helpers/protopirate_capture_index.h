@@ -0,0 +1,69 @@
+// helpers/protopirate_capture_index.h
+#pragma once
+
+#include <furi.h>
+#include <storage/storage.h>
+
+#define PROTOPIRATE_CAPTURE_INDEX_PATH EXT_PATH("subghz/protopirate/captures.idx")
+
+typedef enum
+{
+    ProtoPirateCaptureInfoFlagDeleted = (1 << 0),
+    ProtoPirateCaptureInfoFlagFrequency = (1 << 1),
+    ProtoPirateCaptureInfoFlagSerial = (1 << 2),
+    ProtoPirateCaptureInfoFlagBtn = (1 << 3),
+    ProtoPirateCaptureInfoFlagCnt = (1 << 4),
+    ProtoPirateCaptureInfoFlagCrc = (1 << 5),
+    ProtoPirateCaptureInfoFlagType = (1 << 6),
+} ProtoPirateCaptureInfoFlag;
+
+// One fixed-size index record per saved capture (128 bytes on disk)
+typedef struct
+{
+    uint32_t timestamp;
+    uint32_t frequency;
+    uint32_t serial;
+    uint32_t cnt;
+    uint8_t btn;
+    uint8_t crc;
+    uint8_t type;
+    uint8_t flags;
+    char protocol[28];
+    char path[80]; // Relative to PROTOPIRATE_APP_FOLDER, with extension
+} ProtoPirateCaptureInfo;
+
+#define PROTOPIRATE_CAPTURE_FILTER_ANY 0xFF
+
+// Criteria for narrowing the capture list; answered from RAM only
+typedef struct
+{
+    // By name: interned ids are reassigned whenever the index is reloaded
+    char protocol[sizeof(((ProtoPirateCaptureInfo *)0)->protocol)]; // Empty for any
+    uint8_t btn;
+    uint8_t serial_prefix_len; // Hex digits of serial_prefix that must match
+    uint32_t serial_prefix;
+    uint32_t frequency; // Hz, 0 for any
+} ProtoPirateCaptureFilter;
+
+void protopirate_capture_filter_reset(ProtoPirateCaptureFilter *filter);
+bool protopirate_capture_filter_is_active(const ProtoPirateCaptureFilter *filter);
+
+// Fill info fields from one "Key: value" line of a capture file
+void protopirate_capture_index_parse_line(ProtoPirateCaptureInfo *info, const FuriString *line);
+
+bool protopirate_capture_index_load(void);
+void protopirate_capture_index_unload(void);
+uint32_t protopirate_capture_index_get_count(void);
+bool protopirate_capture_index_get(uint32_t index, ProtoPirateCaptureInfo *out_info);
+
+// Restrict get_count/get to captures matching the filter (NULL clears it)
+void protopirate_capture_index_set_filter(const ProtoPirateCaptureFilter *filter);
+uint8_t protopirate_capture_index_get_protocol_count(void);
+const char *protopirate_capture_index_get_protocol_name(uint8_t protocol_id);
+// Distinct button codes among indexed captures, ascending, at most max of
+// them. 0xFF is the "any" value and never listed.
+uint8_t protopirate_capture_index_get_buttons(uint8_t *out, uint8_t max);
+
+bool protopirate_capture_index_append(const ProtoPirateCaptureInfo *info);
+bool protopirate_capture_index_remove(const char *relative_path);
+bool protopirate_capture_index_rebuild(void);
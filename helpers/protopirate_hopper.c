@@ -0,0 +1,350 @@
+// helpers/protopirate_hopper.c
+#include "protopirate_hopper.h"
+
+#define TAG "ProtoPirateHopper"
+
+// Weight 1 is a frequency with no history; busier ones earn up to WEIGHT_MAX
+// times the share of listening time.
+#define HOPPER_WEIGHT_MAX   8
+#define HOPPER_HIT_WEIGHT   2 // Per decoded frame
+#define HOPPER_ACTIVITY_DIV 4 // RSSI gate openings per weight step
+#define HOPPER_STRIDE       840 // Divisible by every weight
+// Statistics halve every this many ticks, so old activity fades out
+#define HOPPER_DECAY_TICKS 600
+
+// Noise floor is a low percentile of the last NOISE_SAMPLES RSSI readings
+// taken on a frequency; activity is anything RSSI_MARGIN above it
+#define HOPPER_NOISE_SAMPLES       8
+#define HOPPER_NOISE_SAMPLES_MIN   4 // Before this, the fixed default applies
+#define HOPPER_RSSI_MARGIN         10.0f
+#define HOPPER_RSSI_THRESHOLD      -90.0f // Default while the floor is unknown
+// The threshold never drops to where the radio only sees its own noise, nor
+// rises so far that a steady interferer hides everything
+#define HOPPER_RSSI_THRESHOLD_MIN  -100.0f
+#define HOPPER_RSSI_THRESHOLD_MAX  -60.0f
+
+// One preset per modulation family our protocols use
+static const char *const hopper_presets[] = {
+    "AM650",
+    "FM476",
+};
+
+typedef struct
+{
+    uint32_t frequency;
+    uint32_t pass; // Stride scheduling position; lowest goes next
+    uint32_t last_hop; // Hop number of the last visit
+    uint32_t pending_hits; // Added by the worker, folded in on the next hop
+    uint16_t hits;
+    uint16_t activity;
+    uint8_t weight;
+    uint8_t preset;
+    int8_t noise[HOPPER_NOISE_SAMPLES]; // dBm, ring
+    uint8_t noise_head;
+    uint8_t noise_count;
+    float threshold;
+} ProtoPirateHopperEntry;
+
+struct ProtoPirateHopper
+{
+    ProtoPirateHopperEntry entries[PROTOPIRATE_HOPPER_ENTRIES_MAX];
+    SubGhzSetting *setting;
+    bool modulation;
+    uint8_t count;
+    uint8_t dwell;
+    uint32_t hops;
+    uint32_t ticks;
+    uint32_t decay_tick;
+
+    uint32_t latency_last;
+    uint32_t latency_max;
+    uint64_t latency_sum;
+    uint32_t latency_count;
+};
+
+static uint8_t protopirate_hopper_find_preset(SubGhzSetting *setting, const char *name)
+{
+    size_t count = subghz_setting_get_preset_count(setting);
+    for (size_t i = 0; i < count && i < PROTOPIRATE_HOPPER_PRESET_KEEP; i++)
+    {
+        if (!strcmp(subghz_setting_get_preset_name(setting, i), name))
+        {
+            return i;
+        }
+    }
+    FURI_LOG_W(TAG, "Preset %s not found", name);
+    return PROTOPIRATE_HOPPER_PRESET_KEEP;
+}
+
+// Entries are frequency-major, so one round covers every preset on a
+// frequency before moving on
+static void protopirate_hopper_build(ProtoPirateHopper *hopper)
+{
+    uint8_t presets[COUNT_OF(hopper_presets)];
+    uint8_t preset_count = 0;
+    if (hopper->modulation)
+    {
+        for (size_t i = 0; i < COUNT_OF(hopper_presets); i++)
+        {
+            uint8_t preset = protopirate_hopper_find_preset(hopper->setting, hopper_presets[i]);
+            if (preset != PROTOPIRATE_HOPPER_PRESET_KEEP)
+            {
+                presets[preset_count++] = preset;
+            }
+        }
+    }
+    if (!preset_count)
+    {
+        presets[preset_count++] = PROTOPIRATE_HOPPER_PRESET_KEEP;
+    }
+
+    memset(hopper->entries, 0, sizeof(hopper->entries));
+    hopper->count = 0;
+    hopper->hops = 0;
+    size_t frequencies = subghz_setting_get_hopper_frequency_count(hopper->setting);
+    for (size_t i = 0; i < frequencies; i++)
+    {
+        for (uint8_t p = 0; p < preset_count; p++)
+        {
+            if (hopper->count >= PROTOPIRATE_HOPPER_ENTRIES_MAX)
+            {
+                FURI_LOG_W(TAG, "Hopping over the first %d entries", hopper->count);
+                return;
+            }
+            ProtoPirateHopperEntry *entry = &hopper->entries[hopper->count++];
+            entry->frequency = subghz_setting_get_hopper_frequency(hopper->setting, i);
+            entry->preset = presets[p];
+            entry->weight = 1;
+            entry->threshold = HOPPER_RSSI_THRESHOLD;
+        }
+    }
+}
+
+ProtoPirateHopper *protopirate_hopper_alloc(SubGhzSetting *setting)
+{
+    ProtoPirateHopper *hopper = malloc(sizeof(ProtoPirateHopper));
+    memset(hopper, 0, sizeof(ProtoPirateHopper));
+    hopper->setting = setting;
+    protopirate_hopper_build(hopper);
+    return hopper;
+}
+
+void protopirate_hopper_set_modulation(ProtoPirateHopper *hopper, bool modulation)
+{
+    furi_assert(hopper);
+    if (hopper->modulation == modulation)
+    {
+        return;
+    }
+    hopper->modulation = modulation;
+    protopirate_hopper_build(hopper);
+}
+
+void protopirate_hopper_free(ProtoPirateHopper *hopper)
+{
+    furi_assert(hopper);
+    free(hopper);
+}
+
+uint8_t protopirate_hopper_get_count(ProtoPirateHopper *hopper)
+{
+    furi_assert(hopper);
+    return hopper->count;
+}
+
+uint32_t protopirate_hopper_get_frequency(ProtoPirateHopper *hopper, uint8_t idx)
+{
+    furi_assert(hopper);
+    return (idx < hopper->count) ? hopper->entries[idx].frequency : 0;
+}
+
+uint8_t protopirate_hopper_get_preset(ProtoPirateHopper *hopper, uint8_t idx)
+{
+    furi_assert(hopper);
+    return (idx < hopper->count) ? hopper->entries[idx].preset : PROTOPIRATE_HOPPER_PRESET_KEEP;
+}
+
+void protopirate_hopper_add_hit(ProtoPirateHopper *hopper, uint8_t idx)
+{
+    furi_assert(hopper);
+    if (idx < hopper->count)
+    {
+        __atomic_fetch_add(&hopper->entries[idx].pending_hits, 1, __ATOMIC_RELAXED);
+    }
+}
+
+// Floor is the sample at the 25th percentile, so short bursts of signal in
+// the window do not lift it
+static void protopirate_hopper_update_threshold(ProtoPirateHopperEntry *entry)
+{
+    if (entry->noise_count < HOPPER_NOISE_SAMPLES_MIN)
+    {
+        entry->threshold = HOPPER_RSSI_THRESHOLD;
+        return;
+    }
+
+    int8_t sorted[HOPPER_NOISE_SAMPLES];
+    memcpy(sorted, entry->noise, entry->noise_count);
+    uint8_t rank = entry->noise_count / 4;
+    // Partial selection sort, only up to the wanted rank
+    for (uint8_t i = 0; i <= rank; i++)
+    {
+        uint8_t min = i;
+        for (uint8_t j = i + 1; j < entry->noise_count; j++)
+        {
+            if (sorted[j] < sorted[min])
+            {
+                min = j;
+            }
+        }
+        int8_t tmp = sorted[i];
+        sorted[i] = sorted[min];
+        sorted[min] = tmp;
+    }
+
+    float threshold = sorted[rank] + HOPPER_RSSI_MARGIN;
+    entry->threshold =
+        CLAMP(threshold, HOPPER_RSSI_THRESHOLD_MAX, HOPPER_RSSI_THRESHOLD_MIN);
+}
+
+bool protopirate_hopper_add_rssi(ProtoPirateHopper *hopper, uint8_t idx, float rssi)
+{
+    furi_assert(hopper);
+    if (idx >= hopper->count)
+    {
+        return rssi > HOPPER_RSSI_THRESHOLD;
+    }
+
+    ProtoPirateHopperEntry *entry = &hopper->entries[idx];
+    bool active = rssi > entry->threshold;
+
+    entry->noise[entry->noise_head] = (int8_t)CLAMP(rssi, 0.0f, -127.0f);
+    entry->noise_head = (entry->noise_head + 1) % HOPPER_NOISE_SAMPLES;
+    if (entry->noise_count < HOPPER_NOISE_SAMPLES)
+    {
+        entry->noise_count++;
+    }
+    protopirate_hopper_update_threshold(entry);
+
+    if (active && entry->activity < UINT16_MAX)
+    {
+        entry->activity++;
+    }
+    return active;
+}
+
+float protopirate_hopper_get_threshold(ProtoPirateHopper *hopper, uint8_t idx)
+{
+    furi_assert(hopper);
+    return (idx < hopper->count) ? hopper->entries[idx].threshold : HOPPER_RSSI_THRESHOLD;
+}
+
+void protopirate_hopper_add_latency(ProtoPirateHopper *hopper, uint32_t latency_us)
+{
+    furi_assert(hopper);
+    hopper->latency_last = latency_us;
+    hopper->latency_max = MAX(hopper->latency_max, latency_us);
+    hopper->latency_sum += latency_us;
+    hopper->latency_count++;
+}
+
+void protopirate_hopper_get_latency(ProtoPirateHopper *hopper, ProtoPirateHopperLatency *out)
+{
+    furi_assert(hopper);
+    furi_assert(out);
+    out->last_us = hopper->latency_last;
+    out->max_us = hopper->latency_max;
+    out->hops = hopper->latency_count;
+    out->avg_us = hopper->latency_count ? hopper->latency_sum / hopper->latency_count : 0;
+}
+
+bool protopirate_hopper_tick(ProtoPirateHopper *hopper)
+{
+    furi_assert(hopper);
+    hopper->ticks++;
+    if (hopper->dwell > 1)
+    {
+        hopper->dwell--;
+        return false;
+    }
+    return true;
+}
+
+static void protopirate_hopper_update_weights(ProtoPirateHopper *hopper)
+{
+    bool decay = (hopper->ticks - hopper->decay_tick) >= HOPPER_DECAY_TICKS;
+    if (decay)
+    {
+        hopper->decay_tick = hopper->ticks;
+    }
+
+    for (uint8_t i = 0; i < hopper->count; i++)
+    {
+        ProtoPirateHopperEntry *entry = &hopper->entries[i];
+        uint32_t hits =
+            entry->hits + __atomic_exchange_n(&entry->pending_hits, 0, __ATOMIC_RELAXED);
+        entry->hits = MIN(hits, (uint32_t)UINT16_MAX);
+        if (decay)
+        {
+            entry->hits /= 2;
+            entry->activity /= 2;
+        }
+
+        uint32_t score = entry->hits * HOPPER_HIT_WEIGHT + entry->activity / HOPPER_ACTIVITY_DIV;
+        entry->weight = 1 + MIN(score, (uint32_t)(HOPPER_WEIGHT_MAX - 1));
+    }
+}
+
+// Stride scheduling: each frequency advances by STRIDE / weight per visit and
+// the one furthest behind goes next, so listening time follows the weights.
+// A frequency skipped for REVISIT_ROUNDS rounds is taken regardless.
+uint8_t protopirate_hopper_next(ProtoPirateHopper *hopper)
+{
+    furi_assert(hopper);
+    if (!hopper->count)
+    {
+        return 0;
+    }
+
+    protopirate_hopper_update_weights(hopper);
+
+    uint32_t revisit = (uint32_t)hopper->count * PROTOPIRATE_HOPPER_REVISIT_ROUNDS;
+    uint8_t next = hopper->count;
+    uint8_t lowest = 0;
+    for (uint8_t i = 0; i < hopper->count; i++)
+    {
+        const ProtoPirateHopperEntry *entry = &hopper->entries[i];
+        if (next == hopper->count && hopper->hops - entry->last_hop >= revisit)
+        {
+            next = i;
+        }
+        if (entry->pass < hopper->entries[lowest].pass)
+        {
+            lowest = i;
+        }
+    }
+    if (next == hopper->count)
+    {
+        next = lowest;
+    }
+
+    ProtoPirateHopperEntry *entry = &hopper->entries[next];
+    // A forced visit must not leave the entry far behind and let it hog the radio
+    entry->pass =
+        MAX(entry->pass, hopper->entries[lowest].pass) + HOPPER_STRIDE / entry->weight;
+    entry->last_hop = ++hopper->hops;
+
+    // Busier frequencies also hold the radio a little longer per visit
+    hopper->dwell = 1 + (entry->weight - 1) / 3;
+
+    // Keep pass values small; only their differences matter
+    uint32_t base = hopper->entries[lowest].pass;
+    if (base > (1UL << 30))
+    {
+        for (uint8_t i = 0; i < hopper->count; i++)
+        {
+            hopper->entries[i].pass -= MIN(hopper->entries[i].pass, base);
+        }
+    }
+    return next;
+}
@@ -0,0 +1,57 @@
+// helpers/protopirate_hopper.h
+#pragma once
+
+#include <furi.h>
+#include <lib/subghz/subghz_setting.h>
+
+// (frequency, preset) pairs hopped over
+#define PROTOPIRATE_HOPPER_ENTRIES_MAX 32
+// Entry preset meaning "whatever Receiver Config selected"
+#define PROTOPIRATE_HOPPER_PRESET_KEEP 0xFF
+
+// Every entry is visited at least once per this many rounds of the list,
+// however quiet it has been
+#define PROTOPIRATE_HOPPER_REVISIT_ROUNDS 3
+
+// Longest a hop waits for a frame in progress, in hopper ticks; covers the
+// longest supported frame with margin
+#define PROTOPIRATE_HOPPER_HOLDOFF_TICKS 3
+
+typedef struct ProtoPirateHopper ProtoPirateHopper;
+
+ProtoPirateHopper *protopirate_hopper_alloc(SubGhzSetting *setting);
+void protopirate_hopper_free(ProtoPirateHopper *hopper);
+
+// With modulation on, every hopper frequency is paired with each of the AM
+// and FM presets; otherwise the selected preset is kept. Statistics restart.
+void protopirate_hopper_set_modulation(ProtoPirateHopper *hopper, bool modulation);
+
+uint8_t protopirate_hopper_get_count(ProtoPirateHopper *hopper);
+uint32_t protopirate_hopper_get_frequency(ProtoPirateHopper *hopper, uint8_t idx);
+// Setting preset index for idx, or PROTOPIRATE_HOPPER_PRESET_KEEP
+uint8_t protopirate_hopper_get_preset(ProtoPirateHopper *hopper, uint8_t idx);
+
+// A frame was decoded while listening on idx; safe from the worker thread
+void protopirate_hopper_add_hit(ProtoPirateHopper *hopper, uint8_t idx);
+// Feed an RSSI reading taken while listening on idx into its noise floor.
+// True if it is above that frequency's activity threshold.
+bool protopirate_hopper_add_rssi(ProtoPirateHopper *hopper, uint8_t idx, float rssi);
+// Current activity threshold for idx, in dBm
+float protopirate_hopper_get_threshold(ProtoPirateHopper *hopper, uint8_t idx);
+
+typedef struct
+{
+    uint32_t last_us;
+    uint32_t avg_us;
+    uint32_t max_us;
+    uint32_t hops;
+} ProtoPirateHopperLatency;
+
+// Radio dead time of one hop, from leaving RX to listening again
+void protopirate_hopper_add_latency(ProtoPirateHopper *hopper, uint32_t latency_us);
+void protopirate_hopper_get_latency(ProtoPirateHopper *hopper, ProtoPirateHopperLatency *out);
+
+// One hopper tick on the current frequency; true once its dwell is used up
+bool protopirate_hopper_tick(ProtoPirateHopper *hopper);
+// Pick the frequency to listen on next and start its dwell
+uint8_t protopirate_hopper_next(ProtoPirateHopper *hopper);
@@ -0,0 +1,74 @@
+// helpers/protopirate_pulse_ring.c
+#include "protopirate_pulse_ring.h"
+
+#define TAG "ProtoPiratePulseRing"
+
+#define PULSE_RING_MASK (PROTOPIRATE_PULSE_RING_SIZE - 1)
+
+// Written and read on the worker thread only
+struct ProtoPiratePulseRing
+{
+    int16_t pulses[PROTOPIRATE_PULSE_RING_SIZE];
+    uint32_t seq; // Sequence number of the next pulse
+};
+
+ProtoPiratePulseRing *protopirate_pulse_ring_alloc(void)
+{
+    ProtoPiratePulseRing *ring = malloc(sizeof(ProtoPiratePulseRing));
+    protopirate_pulse_ring_reset(ring);
+    return ring;
+}
+
+void protopirate_pulse_ring_free(ProtoPiratePulseRing *ring)
+{
+    furi_assert(ring);
+    free(ring);
+}
+
+void protopirate_pulse_ring_reset(ProtoPiratePulseRing *ring)
+{
+    furi_assert(ring);
+    ring->seq = 0;
+}
+
+uint32_t protopirate_pulse_ring_push(
+    ProtoPiratePulseRing *ring,
+    const LevelDuration *pulses,
+    size_t count)
+{
+    furi_assert(ring);
+    uint32_t first = ring->seq;
+    for (size_t i = 0; i < count; i++)
+    {
+        int16_t duration = MIN(level_duration_get_duration(pulses[i]), (uint32_t)INT16_MAX);
+        ring->pulses[ring->seq++ & PULSE_RING_MASK] =
+            level_duration_get_level(pulses[i]) ? duration : -duration;
+    }
+    return first;
+}
+
+size_t protopirate_pulse_ring_get_window(
+    ProtoPiratePulseRing *ring,
+    uint32_t trigger,
+    size_t pre,
+    size_t post,
+    int16_t *out)
+{
+    furi_assert(ring);
+    furi_assert(out);
+    uint32_t oldest =
+        (ring->seq > PROTOPIRATE_PULSE_RING_SIZE) ? ring->seq - PROTOPIRATE_PULSE_RING_SIZE : 0;
+    if (trigger < oldest || trigger >= ring->seq)
+    {
+        return 0;
+    }
+
+    uint32_t start = (trigger + 1 - oldest > pre) ? trigger + 1 - pre : oldest;
+    uint32_t end = MIN(trigger + 1 + post, ring->seq);
+    size_t count = 0;
+    for (uint32_t seq = start; seq < end; seq++)
+    {
+        out[count++] = ring->pulses[seq & PULSE_RING_MASK];
+    }
+    return count;
+}
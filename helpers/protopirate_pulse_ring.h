@@ -0,0 +1,32 @@
+// helpers/protopirate_pulse_ring.h
+#pragma once
+
+#include <furi.h>
+#include <toolbox/level_duration.h>
+
+// Most recent filtered pulses kept in RAM; a power of two
+#define PROTOPIRATE_PULSE_RING_SIZE 1024
+
+typedef struct ProtoPiratePulseRing ProtoPiratePulseRing;
+
+ProtoPiratePulseRing *protopirate_pulse_ring_alloc(void);
+void protopirate_pulse_ring_free(ProtoPiratePulseRing *ring);
+void protopirate_pulse_ring_reset(ProtoPiratePulseRing *ring);
+
+// Append a batch; returns the sequence number of its first pulse. Pulses are
+// kept in RAW_Data form: microseconds, negative for low level, and clamped
+// to what an int16_t holds.
+uint32_t protopirate_pulse_ring_push(
+    ProtoPiratePulseRing *ring,
+    const LevelDuration *pulses,
+    size_t count);
+
+// Copy up to `pre` pulses ending with pulse `trigger` and up to `post`
+// pulses after it, as far as the ring still holds and has received them.
+// Returns the number copied; out must hold pre + post.
+size_t protopirate_pulse_ring_get_window(
+    ProtoPiratePulseRing *ring,
+    uint32_t trigger,
+    size_t pre,
+    size_t post,
+    int16_t *out);
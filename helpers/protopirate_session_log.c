@@ -0,0 +1,494 @@
+// helpers/protopirate_session_log.c
+#include "protopirate_session_log.h"
+#include "protopirate_storage.h"
+#include <toolbox/stream/stream.h>
+
+#define TAG "ProtoPirateSessionLog"
+
+#define SESSION_LOG_FILE_MAGIC   0x534C5050 // "PPLS"
+#define SESSION_LOG_RECORD_MAGIC 0x52435050 // "PPCR"
+#define SESSION_LOG_VERSION      2
+
+typedef struct
+{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t record_size;
+    uint32_t session_id;
+    uint32_t record_count;
+    uint32_t exported; // Records already written out as key files
+} ProtoPirateSessionLogHeader;
+
+typedef struct
+{
+    uint32_t magic;
+    uint32_t session_id;
+    uint32_t index;
+    uint32_t timestamp;
+    uint32_t frequency;
+    uint16_t length;
+    uint16_t reserved;
+} ProtoPirateSessionLogRecordHeader;
+
+#define SESSION_LOG_PAYLOAD_SIZE \
+    (PROTOPIRATE_SESSION_LOG_RECORD_SIZE - sizeof(ProtoPirateSessionLogRecordHeader))
+
+struct ProtoPirateSessionLog
+{
+    Storage *storage;
+    File *file;
+    uint8_t *record;
+    ProtoPirateSessionLogHeader header;
+    uint32_t record_count;
+    uint32_t allocated_records;
+    uint32_t unflushed_records;
+    uint32_t last_flush_tick;
+};
+
+static uint32_t protopirate_session_log_offset(uint32_t index)
+{
+    return sizeof(ProtoPirateSessionLogHeader) + index * PROTOPIRATE_SESSION_LOG_RECORD_SIZE;
+}
+
+static bool protopirate_session_log_header_valid(const ProtoPirateSessionLogHeader *header)
+{
+    return header->magic == SESSION_LOG_FILE_MAGIC && header->version == SESSION_LOG_VERSION &&
+           header->record_size == PROTOPIRATE_SESSION_LOG_RECORD_SIZE;
+}
+
+// Count records past the last flushed header. Records written after the last
+// sync are kept as long as they carry this session's id and the expected index,
+// so stale data left in preallocated space is never picked up.
+static uint32_t protopirate_session_log_scan(File *file, const ProtoPirateSessionLogHeader *header)
+{
+    uint32_t count = header->record_count;
+    ProtoPirateSessionLogRecordHeader record;
+
+    while (storage_file_seek(file, protopirate_session_log_offset(count), true) &&
+           storage_file_read(file, &record, sizeof(record)) == sizeof(record))
+    {
+        if (record.magic != SESSION_LOG_RECORD_MAGIC || record.session_id != header->session_id ||
+            record.index != count || record.length > SESSION_LOG_PAYLOAD_SIZE)
+        {
+            break;
+        }
+        count++;
+    }
+
+    return count;
+}
+
+static bool protopirate_session_log_write_header(ProtoPirateSessionLog *log)
+{
+    log->header.record_count = log->record_count;
+    if (!storage_file_seek(log->file, 0, true))
+    {
+        return false;
+    }
+    if (storage_file_write(log->file, &log->header, sizeof(log->header)) != sizeof(log->header))
+    {
+        return false;
+    }
+    return storage_file_seek(log->file, protopirate_session_log_offset(log->record_count), true);
+}
+
+static void protopirate_session_log_preallocate(ProtoPirateSessionLog *log, uint32_t records)
+{
+    if (!storage_file_expand(log->file, protopirate_session_log_offset(records)))
+    {
+        // Not fatal: writes still grow the file, just not in one allocation
+        FURI_LOG_W(TAG, "Failed to preallocate %lu records", records);
+    }
+    log->allocated_records = records;
+}
+
+ProtoPirateSessionLog *protopirate_session_log_alloc(void)
+{
+    ProtoPirateSessionLog *log = malloc(sizeof(ProtoPirateSessionLog));
+    memset(log, 0, sizeof(ProtoPirateSessionLog));
+    return log;
+}
+
+void protopirate_session_log_free(ProtoPirateSessionLog *log)
+{
+    furi_assert(log);
+    protopirate_session_log_close(log);
+    free(log);
+}
+
+bool protopirate_session_log_open(ProtoPirateSessionLog *log)
+{
+    furi_assert(log);
+    if (log->file)
+    {
+        return true;
+    }
+
+    if (!protopirate_storage_init())
+    {
+        FURI_LOG_E(TAG, "Failed to create app folder");
+        return false;
+    }
+
+    log->storage = furi_record_open(RECORD_STORAGE);
+    log->file = storage_file_alloc(log->storage);
+    bool result = false;
+
+    do
+    {
+        if (!storage_file_open(
+                log->file, PROTOPIRATE_SESSION_LOG_PATH, FSAM_READ_WRITE, FSOM_OPEN_ALWAYS))
+        {
+            FURI_LOG_E(TAG, "Failed to open %s", PROTOPIRATE_SESSION_LOG_PATH);
+            break;
+        }
+
+        uint64_t size = storage_file_size(log->file);
+        bool have_header =
+            storage_file_read(log->file, &log->header, sizeof(log->header)) == sizeof(log->header) &&
+            protopirate_session_log_header_valid(&log->header);
+
+        if (!have_header && size > 0)
+        {
+            // Unreadable or from another version: may still hold an unexported
+            // session, so keep it for inspection rather than starting over it
+            FURI_LOG_W(
+                TAG,
+                "Session log header %s, moving it to %s",
+                (size < sizeof(log->header)) ? "truncated" : "invalid",
+                PROTOPIRATE_SESSION_LOG_BAD_PATH);
+            storage_file_close(log->file);
+            // An older .bad is never overwritten; it has to be dealt with first
+            if (storage_common_exists(log->storage, PROTOPIRATE_SESSION_LOG_BAD_PATH) ||
+                storage_common_rename(
+                    log->storage,
+                    PROTOPIRATE_SESSION_LOG_PATH,
+                    PROTOPIRATE_SESSION_LOG_BAD_PATH) != FSE_OK)
+            {
+                FURI_LOG_E(TAG, "Cannot set the old session log aside, not opening");
+                break;
+            }
+            if (!storage_file_open(
+                    log->file, PROTOPIRATE_SESSION_LOG_PATH, FSAM_READ_WRITE, FSOM_CREATE_ALWAYS))
+            {
+                FURI_LOG_E(TAG, "Failed to create %s", PROTOPIRATE_SESSION_LOG_PATH);
+                break;
+            }
+        }
+
+        if (have_header)
+        {
+            log->record_count = protopirate_session_log_scan(log->file, &log->header);
+            FURI_LOG_I(
+                TAG,
+                "Resuming session log: %lu records (%lu recovered)",
+                log->record_count,
+                log->record_count - log->header.record_count);
+        }
+        else
+        {
+            log->header.magic = SESSION_LOG_FILE_MAGIC;
+            log->header.version = SESSION_LOG_VERSION;
+            log->header.record_size = PROTOPIRATE_SESSION_LOG_RECORD_SIZE;
+            log->header.session_id = furi_hal_rtc_get_timestamp() ^ furi_get_tick();
+            log->header.exported = 0;
+            log->record_count = 0;
+            if (!storage_file_seek(log->file, 0, true) || !storage_file_truncate(log->file))
+            {
+                FURI_LOG_E(TAG, "Failed to reset session log");
+                break;
+            }
+        }
+
+        if (!protopirate_session_log_write_header(log))
+        {
+            FURI_LOG_E(TAG, "Failed to write session log header");
+            break;
+        }
+
+        protopirate_session_log_preallocate(
+            log, log->record_count + PROTOPIRATE_SESSION_LOG_PREALLOC_RECORDS);
+        if (!storage_file_seek(
+                log->file, protopirate_session_log_offset(log->record_count), true))
+        {
+            break;
+        }
+
+        log->record = malloc(PROTOPIRATE_SESSION_LOG_RECORD_SIZE);
+        log->unflushed_records = 0;
+        log->last_flush_tick = furi_get_tick();
+        result = true;
+    } while (false);
+
+    if (!result)
+    {
+        storage_file_close(log->file);
+        storage_file_free(log->file);
+        log->file = NULL;
+        furi_record_close(RECORD_STORAGE);
+        log->storage = NULL;
+    }
+
+    return result;
+}
+
+void protopirate_session_log_close(ProtoPirateSessionLog *log)
+{
+    furi_assert(log);
+    if (!log->file)
+    {
+        return;
+    }
+
+    protopirate_session_log_flush(log);
+
+    // Give back the unused preallocated tail
+    storage_file_seek(log->file, protopirate_session_log_offset(log->record_count), true);
+    storage_file_truncate(log->file);
+
+    storage_file_close(log->file);
+    storage_file_free(log->file);
+    log->file = NULL;
+    furi_record_close(RECORD_STORAGE);
+    log->storage = NULL;
+
+    free(log->record);
+    log->record = NULL;
+
+    FURI_LOG_I(TAG, "Session log closed with %lu records", log->record_count);
+}
+
+bool protopirate_session_log_is_open(ProtoPirateSessionLog *log)
+{
+    furi_assert(log);
+    return log->file != NULL;
+}
+
+bool protopirate_session_log_append(
+    ProtoPirateSessionLog *log,
+    FlipperFormat *flipper_format,
+    uint32_t frequency)
+{
+    furi_assert(log);
+    furi_assert(flipper_format);
+
+    if (!log->file)
+    {
+        return false;
+    }
+
+    Stream *stream = flipper_format_get_raw_stream(flipper_format);
+    size_t length = stream_size(stream);
+    if (length > SESSION_LOG_PAYLOAD_SIZE)
+    {
+        FURI_LOG_E(TAG, "Capture too large for a log record: %zu bytes", length);
+        return false;
+    }
+
+    ProtoPirateSessionLogRecordHeader *record = (ProtoPirateSessionLogRecordHeader *)log->record;
+    uint8_t *payload = log->record + sizeof(ProtoPirateSessionLogRecordHeader);
+
+    memset(log->record, 0, PROTOPIRATE_SESSION_LOG_RECORD_SIZE);
+    record->magic = SESSION_LOG_RECORD_MAGIC;
+    record->session_id = log->header.session_id;
+    record->index = log->record_count;
+    record->timestamp = furi_hal_rtc_get_timestamp();
+    record->frequency = frequency;
+    record->length = length;
+
+    stream_rewind(stream);
+    if (stream_read(stream, payload, length) != length)
+    {
+        FURI_LOG_E(TAG, "Failed to read capture");
+        return false;
+    }
+
+    if (log->record_count >= log->allocated_records)
+    {
+        protopirate_session_log_preallocate(
+            log, log->allocated_records + PROTOPIRATE_SESSION_LOG_PREALLOC_RECORDS);
+        storage_file_seek(log->file, protopirate_session_log_offset(log->record_count), true);
+    }
+
+    if (storage_file_write(log->file, log->record, PROTOPIRATE_SESSION_LOG_RECORD_SIZE) !=
+        PROTOPIRATE_SESSION_LOG_RECORD_SIZE)
+    {
+        FURI_LOG_E(TAG, "Failed to write record %lu", log->record_count);
+        // Put the write position back so the next append overwrites the partial record
+        storage_file_seek(log->file, protopirate_session_log_offset(log->record_count), true);
+        return false;
+    }
+
+    log->record_count++;
+    log->unflushed_records++;
+
+    if (log->unflushed_records >= PROTOPIRATE_SESSION_LOG_FLUSH_RECORDS ||
+        (furi_get_tick() - log->last_flush_tick) >= furi_ms_to_ticks(PROTOPIRATE_SESSION_LOG_FLUSH_MS))
+    {
+        protopirate_session_log_flush(log);
+    }
+
+    return true;
+}
+
+void protopirate_session_log_flush(ProtoPirateSessionLog *log)
+{
+    furi_assert(log);
+    if (!log->file || log->unflushed_records == 0)
+    {
+        return;
+    }
+
+    if (!protopirate_session_log_write_header(log))
+    {
+        FURI_LOG_E(TAG, "Failed to update session log header");
+    }
+    storage_file_sync(log->file);
+
+    log->unflushed_records = 0;
+    log->last_flush_tick = furi_get_tick();
+}
+
+uint32_t protopirate_session_log_get_count(ProtoPirateSessionLog *log)
+{
+    furi_assert(log);
+    return log->record_count;
+}
+
+uint32_t protopirate_session_log_get_file_record_count(void)
+{
+    Storage *storage = furi_record_open(RECORD_STORAGE);
+    File *file = storage_file_alloc(storage);
+    ProtoPirateSessionLogHeader header;
+    uint32_t count = 0;
+
+    if (storage_file_open(file, PROTOPIRATE_SESSION_LOG_PATH, FSAM_READ, FSOM_OPEN_EXISTING))
+    {
+        if (storage_file_read(file, &header, sizeof(header)) == sizeof(header) &&
+            protopirate_session_log_header_valid(&header))
+        {
+            count = protopirate_session_log_scan(file, &header);
+            count = (header.exported < count) ? count - header.exported : 0;
+        }
+        storage_file_close(file);
+    }
+
+    storage_file_free(file);
+    furi_record_close(RECORD_STORAGE);
+    return count;
+}
+
+bool protopirate_session_log_export(uint32_t *out_exported)
+{
+    Storage *storage = furi_record_open(RECORD_STORAGE);
+    File *file = storage_file_alloc(storage);
+    FlipperFormat *flipper_format = flipper_format_string_alloc();
+    Stream *stream = flipper_format_get_raw_stream(flipper_format);
+    uint8_t *record = malloc(PROTOPIRATE_SESSION_LOG_RECORD_SIZE);
+    FuriString *protocol = furi_string_alloc();
+    ProtoPirateSessionLogHeader header;
+    uint32_t count = 0;
+    uint32_t exported = 0;
+    bool result = false;
+
+    do
+    {
+        if (!storage_file_open(
+                file, PROTOPIRATE_SESSION_LOG_PATH, FSAM_READ_WRITE, FSOM_OPEN_EXISTING))
+        {
+            FURI_LOG_I(TAG, "No session log to export");
+            break;
+        }
+
+        if (storage_file_read(file, &header, sizeof(header)) != sizeof(header) ||
+            !protopirate_session_log_header_valid(&header))
+        {
+            FURI_LOG_E(TAG, "Invalid session log header");
+            break;
+        }
+
+        // Records up to the watermark went out in an earlier, failed pass
+        count = protopirate_session_log_scan(file, &header);
+        uint32_t first = MIN(header.exported, count);
+        bool failed = false;
+
+        for (uint32_t i = first; i < count; i++)
+        {
+            if (!storage_file_seek(file, protopirate_session_log_offset(i), true))
+            {
+                failed = true;
+                break;
+            }
+            if (storage_file_read(file, record, PROTOPIRATE_SESSION_LOG_RECORD_SIZE) !=
+                PROTOPIRATE_SESSION_LOG_RECORD_SIZE)
+            {
+                FURI_LOG_E(TAG, "Short read at record %lu", i);
+                failed = true;
+                break;
+            }
+
+            const ProtoPirateSessionLogRecordHeader *record_header =
+                (const ProtoPirateSessionLogRecordHeader *)record;
+
+            stream_clean(stream);
+            stream_write(
+                stream, record + sizeof(ProtoPirateSessionLogRecordHeader), record_header->length);
+            flipper_format_rewind(flipper_format);
+
+            if (!flipper_format_read_string(flipper_format, "Protocol", protocol))
+            {
+                furi_string_set_str(protocol, "Unknown");
+            }
+            furi_string_replace_all(protocol, "/", "_");
+            furi_string_replace_all(protocol, " ", "_");
+
+            if (!protopirate_storage_save_capture(
+                    flipper_format, furi_string_get_cstr(protocol), NULL))
+            {
+                // Stop here so the watermark covers exactly the files written
+                FURI_LOG_E(TAG, "Failed to export record %lu", i);
+                failed = true;
+                break;
+            }
+            exported++;
+
+            header.exported = i + 1;
+            if (!storage_file_seek(file, 0, true) ||
+                storage_file_write(file, &header, sizeof(header)) != sizeof(header))
+            {
+                FURI_LOG_E(TAG, "Failed to record export progress");
+                failed = true;
+                break;
+            }
+        }
+
+        result = !failed;
+        count -= first;
+    } while (false);
+
+    storage_file_close(file);
+    storage_file_free(file);
+
+    // Only drop the log once every record made it out as a key file
+    if (result)
+    {
+        storage_simply_remove(storage, PROTOPIRATE_SESSION_LOG_PATH);
+    }
+    else if (count > 0)
+    {
+        FURI_LOG_W(TAG, "Exported %lu of %lu records, keeping log", exported, count);
+    }
+
+    furi_string_free(protocol);
+    free(record);
+    flipper_format_free(flipper_format);
+    furi_record_close(RECORD_STORAGE);
+
+    FURI_LOG_I(TAG, "Exported %lu session records", exported);
+    if (out_exported)
+    {
+        *out_exported = exported;
+    }
+
+    return result;
+}
@@ -0,0 +1,40 @@
+// helpers/protopirate_session_log.h
+#pragma once
+
+#include <furi.h>
+#include <storage/storage.h>
+#include <flipper_format/flipper_format.h>
+
+#define PROTOPIRATE_SESSION_LOG_PATH EXT_PATH("subghz/protopirate/session.log")
+// An existing log that cannot be read is moved here instead of being reset
+#define PROTOPIRATE_SESSION_LOG_BAD_PATH EXT_PATH("subghz/protopirate/session.log.bad")
+
+// Every capture occupies one fixed-size record: a small header followed by the
+// serialized key text, zero padded. Fixed records keep appends sequential and
+// let a half-written log be recovered by scanning forward from the last flush.
+#define PROTOPIRATE_SESSION_LOG_RECORD_SIZE     512
+#define PROTOPIRATE_SESSION_LOG_PREALLOC_RECORDS 64
+#define PROTOPIRATE_SESSION_LOG_FLUSH_RECORDS   8
+#define PROTOPIRATE_SESSION_LOG_FLUSH_MS        5000
+
+typedef struct ProtoPirateSessionLog ProtoPirateSessionLog;
+
+ProtoPirateSessionLog *protopirate_session_log_alloc(void);
+void protopirate_session_log_free(ProtoPirateSessionLog *log);
+
+bool protopirate_session_log_open(ProtoPirateSessionLog *log);
+void protopirate_session_log_close(ProtoPirateSessionLog *log);
+bool protopirate_session_log_is_open(ProtoPirateSessionLog *log);
+
+bool protopirate_session_log_append(
+    ProtoPirateSessionLog *log,
+    FlipperFormat *flipper_format,
+    uint32_t frequency);
+void protopirate_session_log_flush(ProtoPirateSessionLog *log);
+uint32_t protopirate_session_log_get_count(ProtoPirateSessionLog *log);
+
+// Work on the log file directly; the log must not be open for writing.
+// Records not yet exported; an export that fails partway resumes after the
+// last record it wrote out.
+uint32_t protopirate_session_log_get_file_record_count(void);
+bool protopirate_session_log_export(uint32_t *out_exported);
@@ -1,5 +1,6 @@
 // helpers/protopirate_settings.c
 #include "protopirate_settings.h"
+#include "protopirate_worker.h"
 #include <storage/storage.h>
 #include <flipper_format/flipper_format.h>
 #include <furi.h>
@@ -13,7 +14,12 @@ void protopirate_settings_set_defaults(ProtoPirateSettings* settings) {
     settings->frequency = 433920000;
     settings->preset_index = 0;
     settings->auto_save = false;
+    settings->session_log = false;
     settings->hopping_enabled = false;
+    settings->hopping_modulation = false;
+    settings->protocols_disabled = 0;
+    settings->pulse_buffer = PROTOPIRATE_WORKER_PULSES_DEFAULT;
+    settings->save_raw = false;
 }
 
 void protopirate_settings_load(ProtoPirateSettings* settings) {
@@ -76,6 +82,43 @@ void protopirate_settings_load(ProtoPirateSettings* settings) {
         }
         settings->hopping_enabled = (hopping_temp == 1);
         
+        // Read session log mode (newer key, kept last so older files still load)
+        uint32_t session_log_temp = 0;
+        if(!flipper_format_read_uint32(ff, "SessionLog", &session_log_temp, 1)) {
+            FURI_LOG_W(TAG, "Failed to read session log mode, using default");
+            session_log_temp = 0;
+        }
+        settings->session_log = (session_log_temp == 1);
+
+        // Read modulation hopping (newer key, after SessionLog for the same reason)
+        uint32_t hop_modulation_temp = 0;
+        if(!flipper_format_read_uint32(ff, "HopModulation", &hop_modulation_temp, 1)) {
+            FURI_LOG_W(TAG, "Failed to read modulation hopping, using default");
+            hop_modulation_temp = 0;
+        }
+        settings->hopping_modulation = (hop_modulation_temp == 1);
+
+        // Read disabled decoders (newer key, missing means all enabled)
+        if(!flipper_format_read_uint32(
+               ff, "DisabledProtocols", &settings->protocols_disabled, 1)) {
+            FURI_LOG_W(TAG, "Failed to read disabled protocols, using default");
+            settings->protocols_disabled = 0;
+        }
+
+        // Read capture ring size (newer key); the worker clamps it to its limits
+        if(!flipper_format_read_uint32(ff, "PulseBuffer", &settings->pulse_buffer, 1)) {
+            FURI_LOG_W(TAG, "Failed to read pulse buffer size, using default");
+            settings->pulse_buffer = PROTOPIRATE_WORKER_PULSES_DEFAULT;
+        }
+
+        // Read raw pulse saving (newer key)
+        uint32_t save_raw_temp = 0;
+        if(!flipper_format_read_uint32(ff, "SaveRaw", &save_raw_temp, 1)) {
+            FURI_LOG_W(TAG, "Failed to read raw pulse saving, using default");
+            save_raw_temp = 0;
+        }
+        settings->save_raw = (save_raw_temp == 1);
+        
         FURI_LOG_I(TAG, "Settings loaded: freq=%lu, preset=%u, auto_save=%d, hopping=%d",
             settings->frequency, settings->preset_index, 
             settings->auto_save, settings->hopping_enabled);
@@ -128,6 +171,35 @@ void protopirate_settings_save(ProtoPirateSettings* settings) {
             break;
         }
         
+        uint32_t session_log_temp = settings->session_log ? 1 : 0;
+        if(!flipper_format_write_uint32(ff, "SessionLog", &session_log_temp, 1)) {
+            FURI_LOG_E(TAG, "Failed to write session log mode");
+            break;
+        }
+
+        uint32_t hop_modulation_temp = settings->hopping_modulation ? 1 : 0;
+        if(!flipper_format_write_uint32(ff, "HopModulation", &hop_modulation_temp, 1)) {
+            FURI_LOG_E(TAG, "Failed to write modulation hopping");
+            break;
+        }
+
+        if(!flipper_format_write_uint32(
+               ff, "DisabledProtocols", &settings->protocols_disabled, 1)) {
+            FURI_LOG_E(TAG, "Failed to write disabled protocols");
+            break;
+        }
+
+        if(!flipper_format_write_uint32(ff, "PulseBuffer", &settings->pulse_buffer, 1)) {
+            FURI_LOG_E(TAG, "Failed to write pulse buffer size");
+            break;
+        }
+
+        uint32_t save_raw_temp = settings->save_raw ? 1 : 0;
+        if(!flipper_format_write_uint32(ff, "SaveRaw", &save_raw_temp, 1)) {
+            FURI_LOG_E(TAG, "Failed to write raw pulse saving");
+            break;
+        }
+        
         FURI_LOG_I(TAG, "Settings saved: freq=%lu, preset=%u, auto_save=%d, hopping=%d",
             settings->frequency, settings->preset_index, 
             settings->auto_save, settings->hopping_enabled);
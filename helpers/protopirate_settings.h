@@ -11,7 +11,12 @@ typedef struct {
     uint32_t frequency;
     uint8_t preset_index;
     bool auto_save;
+    bool session_log;
     bool hopping_enabled;
+    bool hopping_modulation;
+    uint32_t protocols_disabled; // Bit per protopirate_protocol_registry index
+    uint32_t pulse_buffer; // Capture ring size in pulses; file only, no menu item
+    bool save_raw; // Saved captures carry their RAW_Data pulses
 } ProtoPirateSettings;
 
 void protopirate_settings_load(ProtoPirateSettings* settings);
@@ -1,16 +1,28 @@
 // helpers/protopirate_storage.c
 #include "protopirate_storage.h"
 #include <toolbox/stream/file_stream.h>
+#include <toolbox/stream/stream.h>
 #include <toolbox/dir_walk.h>
+#include <furi_hal.h>
+#include "protopirate_capture_index.h"
 
 #define TAG "ProtoPirateStorage"
-#define MAX_FILES_TO_DISPLAY 50
+#define SEQUENCE_CACHE_SIZE 16
+#define SEQUENCE_FILE_NAME ".seq"
+#define SAVE_OPEN_ATTEMPTS 8
+#define CAPTURE_CACHE_SIZE 4
 
-// Structure to hold file info for sorting
 typedef struct {
-    char name[64];
-    uint32_t timestamp;
-} FileEntry;
+    char protocol[32];
+    uint32_t next;
+} SequenceEntry;
+
+typedef struct {
+    char path[128];
+    uint32_t mtime;
+    uint32_t last_used;
+    ProtoPirateCapture capture;
+} CaptureCacheEntry;
 
 bool protopirate_storage_init()
 {
@@ -20,41 +32,162 @@ bool protopirate_storage_init()
     return result;
 }
 
+// Captures are sharded as <folder>/<Protocol>/<YYYYMMDD>/<Protocol>_NNNN.sub so no
+// single FAT directory grows without bound. The next sequence number for each
+// protocol lives in <folder>/<Protocol>/.seq and is cached here, which keeps
+// filename allocation constant time no matter how many captures exist.
+static SequenceEntry g_sequences[SEQUENCE_CACHE_SIZE];
+static uint8_t g_sequence_count = 0;
+static uint8_t g_sequence_evict = 0;
+static char g_last_dir[128] = {0};
+
+static SequenceEntry *protopirate_storage_get_sequence(Storage *storage, const char *protocol_name)
+{
+    for (uint8_t i = 0; i < g_sequence_count; i++)
+    {
+        if (strcmp(g_sequences[i].protocol, protocol_name) == 0)
+        {
+            return &g_sequences[i];
+        }
+    }
+
+    SequenceEntry *entry;
+    if (g_sequence_count < SEQUENCE_CACHE_SIZE)
+    {
+        entry = &g_sequences[g_sequence_count++];
+    }
+    else
+    {
+        entry = &g_sequences[g_sequence_evict];
+        g_sequence_evict = (g_sequence_evict + 1) % SEQUENCE_CACHE_SIZE;
+    }
+
+    strncpy(entry->protocol, protocol_name, sizeof(entry->protocol) - 1);
+    entry->protocol[sizeof(entry->protocol) - 1] = '\0';
+    entry->next = 0;
+
+    FuriString *seq_path = furi_string_alloc_printf(
+        "%s/%s/%s", PROTOPIRATE_APP_FOLDER, protocol_name, SEQUENCE_FILE_NAME);
+    File *file = storage_file_alloc(storage);
+    if (storage_file_open(file, furi_string_get_cstr(seq_path), FSAM_READ, FSOM_OPEN_EXISTING))
+    {
+        if (storage_file_read(file, &entry->next, sizeof(entry->next)) != sizeof(entry->next))
+        {
+            entry->next = 0;
+        }
+        storage_file_close(file);
+    }
+    storage_file_free(file);
+    furi_string_free(seq_path);
+
+    return entry;
+}
+
+static void protopirate_storage_store_sequence(Storage *storage, const SequenceEntry *entry)
+{
+    FuriString *seq_path = furi_string_alloc_printf(
+        "%s/%s/%s", PROTOPIRATE_APP_FOLDER, entry->protocol, SEQUENCE_FILE_NAME);
+    File *file = storage_file_alloc(storage);
+    if (storage_file_open(file, furi_string_get_cstr(seq_path), FSAM_WRITE, FSOM_CREATE_ALWAYS))
+    {
+        storage_file_write(file, &entry->next, sizeof(entry->next));
+        storage_file_close(file);
+    }
+    else
+    {
+        FURI_LOG_W(TAG, "Failed to persist sequence for %s", entry->protocol);
+    }
+    storage_file_free(file);
+    furi_string_free(seq_path);
+}
+
+// Protocol names become directory and file names, so "Kia V3/V4" must not
+// create extra directory levels, nor may any other character FAT rejects
+static void protopirate_storage_sanitize_name(FuriString *name)
+{
+    static const char *const unsafe[] = {"/", "\\", ":", "*", "?", "\"", "<", ">", "|", " "};
+    for (size_t i = 0; i < COUNT_OF(unsafe); i++)
+    {
+        furi_string_replace_all(name, unsafe[i], "_");
+    }
+}
+
+// Make sure the shard directory exists; only touches the FS when the target
+// directory differs from the previous save (new protocol or new day). A save
+// that cannot open its file clears the cache, in case the directory was
+// removed behind our back.
+static bool protopirate_storage_ensure_dir(Storage *storage, const char *protocol_name, FuriString *dir)
+{
+    DateTime datetime;
+    furi_hal_rtc_get_datetime(&datetime);
+    furi_string_printf(
+        dir,
+        "%s/%s/%04u%02u%02u",
+        PROTOPIRATE_APP_FOLDER,
+        protocol_name,
+        datetime.year,
+        datetime.month,
+        datetime.day);
+
+    if (strcmp(g_last_dir, furi_string_get_cstr(dir)) == 0)
+    {
+        return true;
+    }
+
+    FuriString *protocol_dir =
+        furi_string_alloc_printf("%s/%s", PROTOPIRATE_APP_FOLDER, protocol_name);
+    bool result = storage_simply_mkdir(storage, PROTOPIRATE_APP_FOLDER) &&
+                  storage_simply_mkdir(storage, furi_string_get_cstr(protocol_dir)) &&
+                  storage_simply_mkdir(storage, furi_string_get_cstr(dir));
+    furi_string_free(protocol_dir);
+
+    if (result)
+    {
+        strncpy(g_last_dir, furi_string_get_cstr(dir), sizeof(g_last_dir) - 1);
+        g_last_dir[sizeof(g_last_dir) - 1] = '\0';
+    }
+
+    return result;
+}
+
 bool protopirate_storage_get_next_filename(
     const char *protocol_name,
     FuriString *out_filename)
 {
     Storage *storage = furi_record_open(RECORD_STORAGE);
-    FuriString *temp_path = furi_string_alloc();
-    uint32_t index = 0;
-    bool found = false;
+    FuriString *dir = furi_string_alloc();
+    bool result = false;
+
+    FuriString *safe_name = furi_string_alloc_set_str(protocol_name);
+    protopirate_storage_sanitize_name(safe_name);
+    protocol_name = furi_string_get_cstr(safe_name);
 
-    // Find next available index
-    while (!found && index < 999)
+    if (protopirate_storage_ensure_dir(storage, protocol_name, dir))
     {
+        SequenceEntry *entry = protopirate_storage_get_sequence(storage, protocol_name);
         furi_string_printf(
-            temp_path,
-            "%s/%s_%03lu%s",
-            PROTOPIRATE_APP_FOLDER,
+            out_filename,
+            "%s/%s_%04lu%s",
+            furi_string_get_cstr(dir),
             protocol_name,
-            index,
+            entry->next,
             PROTOPIRATE_APP_EXTENSION);
 
-        if (!storage_file_exists(storage, furi_string_get_cstr(temp_path)))
-        {
-            furi_string_set(out_filename, temp_path);
-            found = true;
-        }
-        else
-        {
-            index++;
-        }
+        // Reserve the number up front so a failed save never reuses it
+        entry->next++;
+        protopirate_storage_store_sequence(storage, entry);
+        result = true;
+    }
+    else
+    {
+        FURI_LOG_E(TAG, "Failed to create %s", furi_string_get_cstr(dir));
     }
 
-    furi_string_free(temp_path);
+    furi_string_free(safe_name);
+    furi_string_free(dir);
     furi_record_close(RECORD_STORAGE);
 
-    return found;
+    return result;
 }
 
 bool protopirate_storage_save_capture(
@@ -62,21 +195,7 @@ bool protopirate_storage_save_capture(
     const char *protocol_name,
     FuriString *out_path)
 {
-    if (!protopirate_storage_init())
-    {
-        FURI_LOG_E(TAG, "Failed to create app folder");
-        return false;
-    }
-
     FuriString *file_path = furi_string_alloc();
-
-    if (!protopirate_storage_get_next_filename(protocol_name, file_path))
-    {
-        FURI_LOG_E(TAG, "Failed to get next filename");
-        furi_string_free(file_path);
-        return false;
-    }
-
     Storage *storage = furi_record_open(RECORD_STORAGE);
 
     // Create a new flipper format file for saving
@@ -85,7 +204,24 @@ bool protopirate_storage_save_capture(
 
     do
     {
-        if (!flipper_format_file_open_new(save_file, furi_string_get_cstr(file_path)))
+        // A stale or missing .seq can point at an existing file; open_new
+        // refuses to overwrite, so just take the next number.
+        bool opened = false;
+        for (uint8_t attempt = 0; attempt < SAVE_OPEN_ATTEMPTS && !opened; attempt++)
+        {
+            if (!protopirate_storage_get_next_filename(protocol_name, file_path))
+            {
+                break;
+            }
+            opened = flipper_format_file_open_new(save_file, furi_string_get_cstr(file_path));
+            if (!opened)
+            {
+                // Shard directory may be gone; make the next attempt recreate it
+                g_last_dir[0] = '\0';
+            }
+        }
+
+        if (!opened)
         {
             FURI_LOG_E(TAG, "Failed to create file");
             break;
@@ -98,197 +234,76 @@ bool protopirate_storage_save_capture(
             break;
         }
 
-        // Rewind source format to beginning
-        flipper_format_rewind(flipper_format);
-
-        // Copy ALL data from the source flipper format
-        FuriString *string_value = furi_string_alloc();
-        uint32_t uint32_value;
-        uint32_t *uint32_array = NULL;
-        uint32_t uint32_array_size = 0;
-
-        // Protocol name
-        if (flipper_format_read_string(flipper_format, "Protocol", string_value))
+        // Copy every line of the source in one forward pass. A source that
+        // carries its own file header has it replaced by the one written
+        // above: only its first Filetype line and the Version line right after
+        // it are dropped, as protocols may have a Version field of their own.
+        Stream *src_stream = flipper_format_get_raw_stream(flipper_format);
+        Stream *dst_stream = flipper_format_get_raw_stream(save_file);
+        FuriString *line = furi_string_alloc();
+        ProtoPirateCaptureInfo info;
+        bool copied = true;
+        bool header_seen = false;
+        bool in_header = false;
+
+        memset(&info, 0, sizeof(info));
+
+        stream_rewind(src_stream);
+        while (stream_read_line(src_stream, line))
         {
-            flipper_format_write_string(save_file, "Protocol", string_value);
-        }
-
-        // Bit count
-        flipper_format_rewind(flipper_format);
-        if (flipper_format_read_uint32(flipper_format, "Bit", &uint32_value, 1))
-        {
-            flipper_format_write_uint32(save_file, "Bit", &uint32_value, 1);
-        }
-
-        // Key data
-        flipper_format_rewind(flipper_format);
-        if (flipper_format_read_string(flipper_format, "Key", string_value))
-        {
-            flipper_format_write_string(save_file, "Key", string_value);
-        }
-        else
-        {
-            flipper_format_rewind(flipper_format);
-            if (flipper_format_get_value_count(flipper_format, "Key", &uint32_array_size) && uint32_array_size > 0)
+            if (!header_seen && furi_string_start_with_str(line, "Filetype:"))
             {
-                uint32_array = malloc(sizeof(uint32_t) * uint32_array_size);
-                if (flipper_format_read_uint32(flipper_format, "Key", uint32_array, uint32_array_size))
+                header_seen = true;
+                in_header = true;
+                continue;
+            }
+            if (in_header)
+            {
+                in_header = false;
+                if (furi_string_start_with_str(line, "Version:"))
                 {
-                    flipper_format_write_uint32(save_file, "Key", uint32_array, uint32_array_size);
+                    continue;
                 }
-                free(uint32_array);
-                uint32_array = NULL;
             }
-        }
-
-        // Frequency
-        flipper_format_rewind(flipper_format);
-        if (flipper_format_read_uint32(flipper_format, "Frequency", &uint32_value, 1))
-        {
-            flipper_format_write_uint32(save_file, "Frequency", &uint32_value, 1);
-        }
-
-        // Preset
-        flipper_format_rewind(flipper_format);
-        if (flipper_format_read_string(flipper_format, "Preset", string_value))
-        {
-            flipper_format_write_string(save_file, "Preset", string_value);
-        }
 
-        // Custom preset data if exists
-        flipper_format_rewind(flipper_format);
-        if (flipper_format_get_value_count(flipper_format, "Custom_preset_module", &uint32_array_size) && uint32_array_size > 0)
-        {
-            if (flipper_format_read_string(flipper_format, "Custom_preset_module", string_value))
-            {
-                flipper_format_write_string(save_file, "Custom_preset_module", string_value);
-            }
-        }
+            protopirate_capture_index_parse_line(&info, line);
 
-        flipper_format_rewind(flipper_format);
-        if (flipper_format_get_value_count(flipper_format, "Custom_preset_data", &uint32_array_size) && uint32_array_size > 0)
-        {
-            uint8_t *custom_data = malloc(uint32_array_size);
-            if (flipper_format_read_hex(flipper_format, "Custom_preset_data", custom_data, uint32_array_size))
+            if (furi_string_size(line) == 0 ||
+                furi_string_get_char(line, furi_string_size(line) - 1) != '\n')
             {
-                flipper_format_write_hex(save_file, "Custom_preset_data", custom_data, uint32_array_size);
+                furi_string_push_back(line, '\n');
             }
-            free(custom_data);
-        }
-
-        // Protocol-specific fields - TE
-        flipper_format_rewind(flipper_format);
-        if (flipper_format_read_uint32(flipper_format, "TE", &uint32_value, 1))
-        {
-            flipper_format_write_uint32(save_file, "TE", &uint32_value, 1);
-        }
 
-        // Serial number
-        flipper_format_rewind(flipper_format);
-        if (flipper_format_read_uint32(flipper_format, "Serial", &uint32_value, 1))
-        {
-            flipper_format_write_uint32(save_file, "Serial", &uint32_value, 1);
-        }
-
-        // Button
-        flipper_format_rewind(flipper_format);
-        if (flipper_format_read_uint32(flipper_format, "Btn", &uint32_value, 1))
-        {
-            flipper_format_write_uint32(save_file, "Btn", &uint32_value, 1);
-        }
-
-        // Counter
-        flipper_format_rewind(flipper_format);
-        if (flipper_format_read_uint32(flipper_format, "Cnt", &uint32_value, 1))
-        {
-            flipper_format_write_uint32(save_file, "Cnt", &uint32_value, 1);
-        }
-
-        // CRC
-        flipper_format_rewind(flipper_format);
-        if (flipper_format_read_uint32(flipper_format, "CRC", &uint32_value, 1))
-        {
-            flipper_format_write_uint32(save_file, "CRC", &uint32_value, 1);
-        }
-
-        // Type (for VW)
-        flipper_format_rewind(flipper_format);
-        if (flipper_format_read_uint32(flipper_format, "Type", &uint32_value, 1))
-        {
-            flipper_format_write_uint32(save_file, "Type", &uint32_value, 1);
-        }
-
-        // Check (for VW)
-        flipper_format_rewind(flipper_format);
-        if (flipper_format_read_uint32(flipper_format, "Check", &uint32_value, 1))
-        {
-            flipper_format_write_uint32(save_file, "Check", &uint32_value, 1);
-        }
-
-        // Raw data arrays
-        flipper_format_rewind(flipper_format);
-        if (flipper_format_get_value_count(flipper_format, "RAW_Data", &uint32_array_size) && uint32_array_size > 0)
-        {
-            uint32_array = malloc(sizeof(uint32_t) * uint32_array_size);
-            if (flipper_format_read_uint32(flipper_format, "RAW_Data", uint32_array, uint32_array_size))
+            if (stream_write_string(dst_stream, line) != furi_string_size(line))
             {
-                flipper_format_write_uint32(save_file, "RAW_Data", uint32_array, uint32_array_size);
+                copied = false;
+                break;
             }
-            free(uint32_array);
-        }
-
-        // DataHi/DataLo
-        flipper_format_rewind(flipper_format);
-        if (flipper_format_read_uint32(flipper_format, "DataHi", &uint32_value, 1))
-        {
-            flipper_format_write_uint32(save_file, "DataHi", &uint32_value, 1);
-        }
-
-        flipper_format_rewind(flipper_format);
-        if (flipper_format_read_uint32(flipper_format, "DataLo", &uint32_value, 1))
-        {
-            flipper_format_write_uint32(save_file, "DataLo", &uint32_value, 1);
-        }
-
-        // RawCnt for Kia V2
-        flipper_format_rewind(flipper_format);
-        if (flipper_format_read_uint32(flipper_format, "RawCnt", &uint32_value, 1))
-        {
-            flipper_format_write_uint32(save_file, "RawCnt", &uint32_value, 1);
         }
 
-        // Encrypted/Decrypted for Kia V3/V4
-        flipper_format_rewind(flipper_format);
-        if (flipper_format_read_uint32(flipper_format, "Encrypted", &uint32_value, 1))
-        {
-            flipper_format_write_uint32(save_file, "Encrypted", &uint32_value, 1);
-        }
-
-        flipper_format_rewind(flipper_format);
-        if (flipper_format_read_uint32(flipper_format, "Decrypted", &uint32_value, 1))
-        {
-            flipper_format_write_uint32(save_file, "Decrypted", &uint32_value, 1);
-        }
+        furi_string_free(line);
 
-        // Version for Kia V3/V4
-        flipper_format_rewind(flipper_format);
-        if (flipper_format_read_uint32(flipper_format, "Version", &uint32_value, 1))
+        if (!copied)
         {
-            flipper_format_write_uint32(save_file, "Version", &uint32_value, 1);
+            FURI_LOG_E(TAG, "Failed to write capture data");
+            break;
         }
 
-        // BS byte for Ford
-        flipper_format_rewind(flipper_format);
-        if (flipper_format_read_uint32(flipper_format, "BS", &uint32_value, 1))
+        if (out_path)
         {
-            flipper_format_write_uint32(save_file, "BS", &uint32_value, 1);
+            furi_string_set(out_path, file_path);
         }
 
-        furi_string_free(string_value);
-
-        if (out_path)
+        // Record the capture in the index so the browser never has to open it
+        strncpy(
+            info.path,
+            furi_string_get_cstr(file_path) + strlen(PROTOPIRATE_APP_FOLDER) + 1,
+            sizeof(info.path) - 1);
+        info.timestamp = furi_hal_rtc_get_timestamp();
+        flipper_format_file_close(save_file);
+        if (!protopirate_capture_index_append(&info))
         {
-            furi_string_set(out_path, file_path);
+            FURI_LOG_W(TAG, "Failed to index %s", info.path);
         }
 
         result = true;
@@ -303,134 +318,133 @@ bool protopirate_storage_save_capture(
     return result;
 }
 
-// Static array to hold sorted file entries
-static FileEntry *g_file_entries = NULL;
-static uint32_t g_file_count = 0;
-
-// Build the sorted file list
-static void protopirate_storage_build_file_list(void)
+// The Saved Captures browser reads only the capture index; the folder is
+// walked just once to rebuild it when the index is missing.
+uint32_t protopirate_storage_get_file_count()
 {
-    // Free previous list
-    if (g_file_entries)
+    if (!protopirate_capture_index_load())
     {
-        free(g_file_entries);
-        g_file_entries = NULL;
+        FURI_LOG_E(TAG, "Failed to load capture index");
+        return 0;
     }
-    g_file_count = 0;
+    return protopirate_capture_index_get_count();
+}
 
-    Storage *storage = furi_record_open(RECORD_STORAGE);
-    File *dir = storage_file_alloc(storage);
-    FileInfo file_info;
+bool protopirate_storage_get_file_info(uint32_t index, ProtoPirateCaptureInfo *out_info)
+{
+    return protopirate_capture_index_get(index, out_info);
+}
 
-    // First pass: count files
-    uint32_t total_count = 0;
-    if (storage_dir_open(dir, PROTOPIRATE_APP_FOLDER))
+bool protopirate_storage_get_file_by_index(
+    uint32_t index,
+    FuriString *out_path,
+    FuriString *out_name)
+{
+    ProtoPirateCaptureInfo info;
+    if (!protopirate_capture_index_get(index, &info))
     {
-        char name[256];
-        while (storage_dir_read(dir, &file_info, name, sizeof(name)))
-        {
-            if (!file_info_is_dir(&file_info) && strstr(name, PROTOPIRATE_APP_EXTENSION))
-            {
-                total_count++;
-            }
-        }
-        storage_dir_close(dir);
+        return false;
     }
 
-    if (total_count == 0)
+    if (out_path)
     {
-        storage_file_free(dir);
-        furi_record_close(RECORD_STORAGE);
-        return;
+        furi_string_printf(out_path, "%s/%s", PROTOPIRATE_APP_FOLDER, info.path);
     }
-
-    // Allocate array
-    g_file_entries = malloc(sizeof(FileEntry) * total_count);
-    if (!g_file_entries)
+    if (out_name)
     {
-        storage_file_free(dir);
-        furi_record_close(RECORD_STORAGE);
-        return;
+        // Display just the file name, without shard directories or extension
+        const char *name = strrchr(info.path, '/');
+        name = name ? name + 1 : info.path;
+        const char *dot = strrchr(name, '.');
+        furi_string_set_strn(out_name, name, dot ? (size_t)(dot - name) : strlen(name));
     }
 
-    // Second pass: collect file info
-    FuriString *full_path = furi_string_alloc();
-    if (storage_dir_open(dir, PROTOPIRATE_APP_FOLDER))
-    {
-        char name[256];
-        while (storage_dir_read(dir, &file_info, name, sizeof(name)) && g_file_count < total_count)
-        {
-            if (!file_info_is_dir(&file_info) && strstr(name, PROTOPIRATE_APP_EXTENSION))
-            {
-                // Copy name (without extension for display)
-                strncpy(g_file_entries[g_file_count].name, name, sizeof(g_file_entries[g_file_count].name) - 1);
-                g_file_entries[g_file_count].name[sizeof(g_file_entries[g_file_count].name) - 1] = '\0';
-
-                // Remove extension
-                char *dot = strrchr(g_file_entries[g_file_count].name, '.');
-                if (dot) *dot = '\0';
-
-                // Get file timestamp
-                furi_string_printf(full_path, "%s/%s", PROTOPIRATE_APP_FOLDER, name);
-
-                // File Count
-                g_file_entries[g_file_count].timestamp = total_count - g_file_count;
+    return true;
+}
 
-                g_file_count++;
-            }
-        }
-        storage_dir_close(dir);
-    }
-    furi_string_free(full_path);
+// Recently loaded captures, keyed by path and modification time. The time
+// only has FAT resolution, so whoever rewrites a file in place (emulate
+// updates Btn/Cnt) also drops its entry.
+static CaptureCacheEntry g_captures[CAPTURE_CACHE_SIZE];
+static uint8_t g_capture_count = 0;
+static uint32_t g_capture_clock = 0;
 
-    // Reverse file count so newest files are first
-    if (g_file_count > 1)
+static void protopirate_storage_parse_key(ProtoPirateCapture *capture, const char *str)
+{
+    uint8_t digits = 0;
+    capture->key = 0;
+    for (; *str && *str != '\r' && *str != '\n'; str++)
     {
-        // Reverse the array so newest (last found) is first
-        for (uint32_t i = 0; i < g_file_count / 2; i++)
+        char c = *str;
+        uint8_t nibble;
+        if (c >= '0' && c <= '9')
+        {
+            nibble = c - '0';
+        }
+        else if (c >= 'A' && c <= 'F')
         {
-            FileEntry temp = g_file_entries[i];
-            g_file_entries[i] = g_file_entries[g_file_count - 1 - i];
-            g_file_entries[g_file_count - 1 - i] = temp;
+            nibble = c - 'A' + 10;
         }
+        else if (c >= 'a' && c <= 'f')
+        {
+            nibble = c - 'a' + 10;
+        }
+        else
+        {
+            continue;
+        }
+        if (digits++ >= 16)
+        {
+            break;
+        }
+        capture->key = (capture->key << 4) | nibble;
     }
-
-    storage_file_free(dir);
-    furi_record_close(RECORD_STORAGE);
-
-    FURI_LOG_I(TAG, "Built file list with %lu entries", g_file_count);
+    capture->has_key = (digits > 0);
 }
 
-uint32_t protopirate_storage_get_file_count()
+static void protopirate_storage_parse_capture_line(ProtoPirateCapture *capture, const FuriString *line)
 {
-    // Rebuild the file list each time we're asked for count
-    protopirate_storage_build_file_list();
-    return g_file_count;
-}
+    const char *str = furi_string_get_cstr(line);
 
-bool protopirate_storage_get_file_by_index(
-    uint32_t index,
-    FuriString *out_path,
-    FuriString *out_name)
-{
-    if (!g_file_entries || index >= g_file_count)
+    if (strncmp(str, "Preset:", 7) == 0)
     {
-        return false;
+        const char *name = str + 7;
+        while (*name == ' ')
+        {
+            name++;
+        }
+        size_t len = strcspn(name, "\r\n");
+        if (len >= sizeof(capture->preset))
+        {
+            len = sizeof(capture->preset) - 1;
+        }
+        memcpy(capture->preset, name, len);
+        capture->preset[len] = '\0';
     }
-
-    if (out_path)
+    else if (strncmp(str, "Bit:", 4) == 0)
     {
-        furi_string_printf(out_path, "%s/%s%s",
-            PROTOPIRATE_APP_FOLDER,
-            g_file_entries[index].name,
-            PROTOPIRATE_APP_EXTENSION);
+        capture->bit_count = strtoul(str + 4, NULL, 10);
     }
-    if (out_name)
+    else if (strncmp(str, "Key:", 4) == 0)
     {
-        furi_string_set_str(out_name, g_file_entries[index].name);
+        protopirate_storage_parse_key(capture, str + 4);
     }
+    else
+    {
+        protopirate_capture_index_parse_line(&capture->info, line);
+    }
+}
 
-    return true;
+void protopirate_storage_forget_capture(const char *file_path)
+{
+    for (uint8_t i = 0; i < g_capture_count; i++)
+    {
+        if (strcmp(g_captures[i].path, file_path) == 0)
+        {
+            g_captures[i] = g_captures[--g_capture_count];
+            return;
+        }
+    }
 }
 
 bool protopirate_storage_delete_file(const char *file_path)
@@ -439,6 +453,16 @@ bool protopirate_storage_delete_file(const char *file_path)
     bool result = storage_simply_remove(storage, file_path);
     FURI_LOG_I(TAG, "Delete file %s: %s", file_path, result ? "OK" : "FAILED");
     furi_record_close(RECORD_STORAGE);
+
+    protopirate_storage_forget_capture(file_path);
+
+    const size_t folder_len = strlen(PROTOPIRATE_APP_FOLDER);
+    if (result && strncmp(file_path, PROTOPIRATE_APP_FOLDER, folder_len) == 0 &&
+        file_path[folder_len] == '/')
+    {
+        protopirate_capture_index_remove(file_path + folder_len + 1);
+    }
+
     return result;
 }
 
@@ -458,13 +482,97 @@ FlipperFormat *protopirate_storage_load_file(const char *file_path)
     return flipper_format;
 }
 
+bool protopirate_storage_load_capture(const char *file_path, ProtoPirateCapture *out_capture)
+{
+    furi_assert(file_path);
+    furi_assert(out_capture);
+
+    Storage *storage = furi_record_open(RECORD_STORAGE);
+    uint32_t mtime = 0;
+    bool result = false;
+
+    do
+    {
+        if (storage_common_timestamp(storage, file_path, &mtime) != FSE_OK)
+        {
+            FURI_LOG_E(TAG, "Failed to stat %s", file_path);
+            break;
+        }
+
+        for (uint8_t i = 0; i < g_capture_count; i++)
+        {
+            if (g_captures[i].mtime == mtime && strcmp(g_captures[i].path, file_path) == 0)
+            {
+                g_captures[i].last_used = ++g_capture_clock;
+                *out_capture = g_captures[i].capture;
+                result = true;
+                break;
+            }
+        }
+        if (result)
+        {
+            break;
+        }
+
+        Stream *stream = file_stream_alloc(storage);
+        FuriString *line = furi_string_alloc();
+        ProtoPirateCapture capture;
+        memset(&capture, 0, sizeof(capture));
+
+        if (file_stream_open(stream, file_path, FSAM_READ, FSOM_OPEN_EXISTING))
+        {
+            while (stream_read_line(stream, line))
+            {
+                protopirate_storage_parse_capture_line(&capture, line);
+            }
+            result = true;
+        }
+        else
+        {
+            FURI_LOG_E(TAG, "Failed to open file %s", file_path);
+        }
+        file_stream_close(stream);
+        stream_free(stream);
+        furi_string_free(line);
+
+        if (!result)
+        {
+            break;
+        }
+
+        // Take a free slot, a stale copy of this path, or the least recently used
+        protopirate_storage_forget_capture(file_path);
+        CaptureCacheEntry *entry = &g_captures[0];
+        if (g_capture_count < CAPTURE_CACHE_SIZE)
+        {
+            entry = &g_captures[g_capture_count++];
+        }
+        else
+        {
+            for (uint8_t i = 1; i < CAPTURE_CACHE_SIZE; i++)
+            {
+                if (g_captures[i].last_used < entry->last_used)
+                {
+                    entry = &g_captures[i];
+                }
+            }
+        }
+        strncpy(entry->path, file_path, sizeof(entry->path) - 1);
+        entry->path[sizeof(entry->path) - 1] = '\0';
+        entry->mtime = mtime;
+        entry->last_used = ++g_capture_clock;
+        entry->capture = capture;
+
+        *out_capture = capture;
+    } while (false);
+
+    furi_record_close(RECORD_STORAGE);
+    return result;
+}
+
 // Call this when exiting the app to free memory
 void protopirate_storage_free_file_list(void)
 {
-    if (g_file_entries)
-    {
-        free(g_file_entries);
-        g_file_entries = NULL;
-    }
-    g_file_count = 0;
+    protopirate_capture_index_unload();
+    g_capture_count = 0;
 }
\ No newline at end of file
@@ -4,11 +4,22 @@
 #include <furi.h>
 #include <storage/storage.h>
 #include <flipper_format/flipper_format.h>
+#include "protopirate_capture_index.h"
 
 #define PROTOPIRATE_APP_FOLDER EXT_PATH("subghz/protopirate")
 #define PROTOPIRATE_APP_EXTENSION ".sub"
 #define PROTOPIRATE_APP_FILE_VERSION 1
 
+// Typed contents of a saved capture, read in a single pass
+typedef struct
+{
+    ProtoPirateCaptureInfo info; // Protocol, Frequency, Serial, Btn, Cnt, CRC, Type
+    char preset[40];
+    uint64_t key;
+    uint32_t bit_count;
+    bool has_key;
+} ProtoPirateCapture;
+
 bool protopirate_storage_init();
 bool protopirate_storage_save_capture(
     FlipperFormat *flipper_format,
@@ -19,6 +30,11 @@ bool protopirate_storage_get_next_filename(
     FuriString *out_filename);
 uint32_t protopirate_storage_get_file_count();
 bool protopirate_storage_get_file_by_index(uint32_t index, FuriString *out_path, FuriString *out_name);
+bool protopirate_storage_get_file_info(uint32_t index, ProtoPirateCaptureInfo *out_info);
 bool protopirate_storage_delete_file(const char *file_path);
 FlipperFormat *protopirate_storage_load_file(const char *file_path);
+bool protopirate_storage_load_capture(const char *file_path, ProtoPirateCapture *out_capture);
+// Drop the cached copy of a capture; call after rewriting the file in place,
+// as its timestamp may not have moved
+void protopirate_storage_forget_capture(const char *file_path);
 void protopirate_storage_free_file_list(void);
\ No newline at end of file
@@ -12,6 +12,7 @@ typedef enum
     ProtoPirateViewReceiver,
     ProtoPirateViewReceiverInfo,
     ProtoPirateViewAbout,
+    ProtoPirateViewTextInput,
 } ProtoPirateView;
 
 typedef enum
@@ -24,6 +25,7 @@ typedef enum
     // Custom events for scenes
     ProtoPirateCustomEventSceneReceiverUpdate,
     ProtoPirateCustomEventSceneSettingLock,
+    ProtoPirateCustomEventSceneSettingClearHistory,
     // File management
     ProtoPirateCustomEventReceiverInfoSave,
     ProtoPirateCustomEventSavedInfoDelete,
@@ -34,6 +36,10 @@ typedef enum
     ProtoPirateCustomEventEmulateExit,
     // Sub decode
     ProtoPirateCustomEventSubDecodeSave,
+    // Saved captures filter
+    ProtoPirateCustomEventSavedFilterSerial,
+    ProtoPirateCustomEventSavedFilterSerialDone,
+    ProtoPirateCustomEventSavedFilterClear,
 } ProtoPirateCustomEvent;
 
 typedef enum
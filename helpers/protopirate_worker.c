@@ -0,0 +1,255 @@
+// helpers/protopirate_worker.c
+#include "protopirate_worker.h"
+#include <furi_hal.h>
+
+#define TAG "ProtoPirateWorker"
+
+// Pulses shorter than this are glitches and merge into their neighbours
+#define WORKER_FILTER_US 30
+
+struct ProtoPirateWorker
+{
+    FuriThread *thread;
+    FuriStreamBuffer *stream;
+    volatile bool running;
+    volatile bool overrun;
+
+    bool filter_level;
+    uint32_t filter_duration;
+    LevelDuration batch[PROTOPIRATE_WORKER_BATCH];
+
+    ProtoPirateWorkerBatchCallback batch_callback;
+    ProtoPirateWorkerOverrunCallback overrun_callback;
+    ProtoPirateWorkerMarkerCallback marker_callback;
+    void *context;
+
+    uint32_t marks_requested; // Written by protopirate_worker_mark
+    // Written by the ISR
+    uint32_t marks_sent;
+    volatile uint32_t overruns;
+    volatile uint32_t dropped;
+    // Written by the worker thread
+    uint32_t pulses;
+    uint32_t batches;
+    uint64_t batch_us_sum;
+    uint32_t batch_us_max;
+    uint32_t overrun_tick;
+};
+
+// A reset marker takes the place of the first pulse that fits after an
+// overrun, so the thread learns where the gap is. Requested markers (a wait
+// LevelDuration) go in before the pulse.
+void protopirate_worker_rx_callback(bool level, uint32_t duration, void *context)
+{
+    ProtoPirateWorker *worker = context;
+    while (worker->marks_sent != __atomic_load_n(&worker->marks_requested, __ATOMIC_ACQUIRE))
+    {
+        LevelDuration marker = level_duration_wait();
+        if (furi_stream_buffer_send(worker->stream, &marker, sizeof(LevelDuration), 0) !=
+            sizeof(LevelDuration))
+        {
+            // Full; the pulse below is lost too and the marker goes in later
+            break;
+        }
+        worker->marks_sent++;
+    }
+
+    LevelDuration level_duration = level_duration_make(level, duration);
+    if (worker->overrun)
+    {
+        level_duration = level_duration_reset();
+    }
+    size_t ret =
+        furi_stream_buffer_send(worker->stream, &level_duration, sizeof(LevelDuration), 0);
+    if (ret == sizeof(LevelDuration))
+    {
+        worker->overrun = false;
+        return;
+    }
+
+    if (!worker->overrun)
+    {
+        worker->overrun = true;
+        worker->overruns++;
+    }
+    worker->dropped++;
+}
+
+static void protopirate_worker_deliver(ProtoPirateWorker *worker, size_t count)
+{
+    if (!count || !worker->batch_callback)
+    {
+        return;
+    }
+    uint32_t start = DWT->CYCCNT;
+    worker->batch_callback(worker->context, worker->batch, count);
+    uint32_t batch_us = (DWT->CYCCNT - start) / furi_hal_cortex_instructions_per_microsecond();
+
+    worker->pulses += count;
+    worker->batches++;
+    worker->batch_us_sum += batch_us;
+    worker->batch_us_max = MAX(worker->batch_us_max, batch_us);
+}
+
+static int32_t protopirate_worker_thread(void *context)
+{
+    ProtoPirateWorker *worker = context;
+    LevelDuration raw[PROTOPIRATE_WORKER_BATCH];
+
+    while (worker->running)
+    {
+        size_t received = furi_stream_buffer_receive(worker->stream, raw, sizeof(raw), 10) /
+                          sizeof(LevelDuration);
+        size_t count = 0;
+
+        for (size_t i = 0; i < received; i++)
+        {
+            if (level_duration_is_reset(raw[i]))
+            {
+                // Everything before the gap goes out first, then the overrun
+                protopirate_worker_deliver(worker, count);
+                count = 0;
+                worker->overrun_tick = furi_get_tick();
+                FURI_LOG_W(TAG, "Overrun, %lu pulses dropped so far", worker->dropped);
+                if (worker->overrun_callback)
+                {
+                    worker->overrun_callback(worker->context);
+                }
+                worker->filter_duration = 0;
+                continue;
+            }
+
+            if (level_duration_is_wait(raw[i]))
+            {
+                // Everything heard before the marker goes out first, with no
+                // pulse carried across it
+                protopirate_worker_deliver(worker, count);
+                count = 0;
+                worker->filter_duration = 0;
+                if (worker->marker_callback)
+                {
+                    worker->marker_callback(worker->context);
+                }
+                continue;
+            }
+
+            bool level = level_duration_get_level(raw[i]);
+            uint32_t duration = level_duration_get_duration(raw[i]);
+            if (duration < WORKER_FILTER_US || level == worker->filter_level)
+            {
+                worker->filter_duration += duration;
+                continue;
+            }
+
+            if (worker->filter_duration)
+            {
+                worker->batch[count++] =
+                    level_duration_make(worker->filter_level, worker->filter_duration);
+            }
+            worker->filter_level = level;
+            worker->filter_duration = duration;
+        }
+        protopirate_worker_deliver(worker, count);
+    }
+    return 0;
+}
+
+ProtoPirateWorker *protopirate_worker_alloc(size_t pulses)
+{
+    ProtoPirateWorker *worker = malloc(sizeof(ProtoPirateWorker));
+    memset(worker, 0, sizeof(ProtoPirateWorker));
+
+    pulses = CLAMP(pulses, PROTOPIRATE_WORKER_PULSES_MAX, PROTOPIRATE_WORKER_PULSES_MIN);
+    worker->stream =
+        furi_stream_buffer_alloc(sizeof(LevelDuration) * pulses, sizeof(LevelDuration));
+    worker->thread =
+        furi_thread_alloc_ex("ProtoPirateWorker", 2048, protopirate_worker_thread, worker);
+    FURI_LOG_I(TAG, "Pulse ring of %zu", pulses);
+    return worker;
+}
+
+void protopirate_worker_free(ProtoPirateWorker *worker)
+{
+    furi_assert(worker);
+    furi_assert(!worker->running);
+    furi_thread_free(worker->thread);
+    furi_stream_buffer_free(worker->stream);
+    free(worker);
+}
+
+void protopirate_worker_set_batch_callback(
+    ProtoPirateWorker *worker,
+    ProtoPirateWorkerBatchCallback callback)
+{
+    furi_assert(worker);
+    worker->batch_callback = callback;
+}
+
+void protopirate_worker_set_overrun_callback(
+    ProtoPirateWorker *worker,
+    ProtoPirateWorkerOverrunCallback callback)
+{
+    furi_assert(worker);
+    worker->overrun_callback = callback;
+}
+
+void protopirate_worker_set_marker_callback(
+    ProtoPirateWorker *worker,
+    ProtoPirateWorkerMarkerCallback callback)
+{
+    furi_assert(worker);
+    worker->marker_callback = callback;
+}
+
+void protopirate_worker_set_context(ProtoPirateWorker *worker, void *context)
+{
+    furi_assert(worker);
+    worker->context = context;
+}
+
+void protopirate_worker_start(ProtoPirateWorker *worker)
+{
+    furi_assert(worker);
+    furi_assert(!worker->running);
+    worker->filter_duration = 0;
+    worker->running = true;
+    furi_thread_start(worker->thread);
+}
+
+void protopirate_worker_stop(ProtoPirateWorker *worker)
+{
+    furi_assert(worker);
+    furi_assert(worker->running);
+    worker->running = false;
+    furi_thread_join(worker->thread);
+    // Pulses left over would otherwise be decoded on the next start
+    furi_stream_buffer_reset(worker->stream);
+    worker->overrun = false;
+    // The ISR is stopped by now, so markers it never sent can be dropped
+    worker->marks_sent = worker->marks_requested;
+}
+
+bool protopirate_worker_is_running(ProtoPirateWorker *worker)
+{
+    furi_assert(worker);
+    return worker->running;
+}
+
+void protopirate_worker_mark(ProtoPirateWorker *worker)
+{
+    furi_assert(worker);
+    __atomic_add_fetch(&worker->marks_requested, 1, __ATOMIC_RELEASE);
+}
+
+void protopirate_worker_get_stats(ProtoPirateWorker *worker, ProtoPirateWorkerStats *out)
+{
+    furi_assert(worker);
+    furi_assert(out);
+    out->pulses = worker->pulses;
+    out->overruns = worker->overruns;
+    out->overrun_tick = worker->overrun_tick;
+    out->dropped = worker->dropped;
+    out->batches = worker->batches;
+    out->batch_us_avg = worker->batches ? worker->batch_us_sum / worker->batches : 0;
+    out->batch_us_max = worker->batch_us_max;
+}
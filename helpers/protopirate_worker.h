@@ -0,0 +1,62 @@
+// helpers/protopirate_worker.h
+#pragma once
+
+#include <furi.h>
+#include <toolbox/level_duration.h>
+
+// Pulses the ring between the radio ISR and the worker thread can hold
+#define PROTOPIRATE_WORKER_PULSES_DEFAULT 6144
+#define PROTOPIRATE_WORKER_PULSES_MIN     1024
+#define PROTOPIRATE_WORKER_PULSES_MAX     16384
+// Most filtered pulses handed to the batch callback at once
+#define PROTOPIRATE_WORKER_BATCH 64
+
+typedef struct ProtoPirateWorker ProtoPirateWorker;
+
+// Runs on the worker thread with pulses already glitch filtered
+typedef void (
+    *ProtoPirateWorkerBatchCallback)(void *context, const LevelDuration *pulses, size_t count);
+// The ring filled up and pulses were lost; the next batch does not continue
+// the last one
+typedef void (*ProtoPirateWorkerOverrunCallback)(void *context);
+// The worker reached a marker from protopirate_worker_mark; pulses before it
+// have all been delivered, pulses after it come next
+typedef void (*ProtoPirateWorkerMarkerCallback)(void *context);
+
+typedef struct
+{
+    uint32_t pulses; // Delivered to the batch callback
+    uint32_t overruns; // Times the ring filled up
+    uint32_t overrun_tick; // furi_get_tick() when the last gap reached the thread
+    uint32_t dropped; // Pulses lost to overruns
+    uint32_t batches;
+    uint32_t batch_us_avg; // Time spent in the batch callback
+    uint32_t batch_us_max;
+} ProtoPirateWorkerStats;
+
+ProtoPirateWorker *protopirate_worker_alloc(size_t pulses);
+void protopirate_worker_free(ProtoPirateWorker *worker);
+
+void protopirate_worker_set_batch_callback(
+    ProtoPirateWorker *worker,
+    ProtoPirateWorkerBatchCallback callback);
+void protopirate_worker_set_overrun_callback(
+    ProtoPirateWorker *worker,
+    ProtoPirateWorkerOverrunCallback callback);
+void protopirate_worker_set_marker_callback(
+    ProtoPirateWorker *worker,
+    ProtoPirateWorkerMarkerCallback callback);
+void protopirate_worker_set_context(ProtoPirateWorker *worker, void *context);
+
+void protopirate_worker_start(ProtoPirateWorker *worker);
+void protopirate_worker_stop(ProtoPirateWorker *worker);
+bool protopirate_worker_is_running(ProtoPirateWorker *worker);
+// Have the ISR put a marker in the stream ahead of the next pulse it hears,
+// so the thread learns where pulses from before a retune end. Markers still
+// pending when the worker stops are dropped.
+void protopirate_worker_mark(ProtoPirateWorker *worker);
+
+// Async RX callback for subghz_devices_start_async_rx; runs in the ISR
+void protopirate_worker_rx_callback(bool level, uint32_t duration, void *context);
+
+void protopirate_worker_get_stats(ProtoPirateWorker *worker, ProtoPirateWorkerStats *out);
@@ -0,0 +1,76 @@
+// protocols/decode_result.h
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Most extra fields any protocol reports alongside its key
+#define PROTOPIRATE_DECODE_FIELDS_MAX 6
+
+// Decoder progress through a frame: 0 when idle, the preamble pulses seen
+// while in the preamble, this once it is collecting data
+#define PROTOPIRATE_DECODER_PROGRESS_DATA UINT16_MAX
+// Progress from which a decoder counts as mid-frame; noise rarely strings
+// this many valid preamble pulses together
+#define PROTOPIRATE_DECODER_BUSY_HEADER 8
+
+// Extra fields, named as they appear in saved captures
+typedef enum {
+    ProtoPirateFieldSerial,
+    ProtoPirateFieldBtn,
+    ProtoPirateFieldCnt,
+    ProtoPirateFieldCrc,
+    ProtoPirateFieldType,
+    ProtoPirateFieldBs,
+    ProtoPirateFieldEncrypted,
+    ProtoPirateFieldDecrypted,
+    ProtoPirateFieldVersion,
+    ProtoPirateFieldCheck,
+    ProtoPirateFieldDataHi,
+    ProtoPirateFieldDataLo,
+    ProtoPirateFieldRawCnt,
+    ProtoPirateFieldCount,
+} ProtoPirateField;
+
+typedef enum {
+    ProtoPirateDecodeResultFlagKeyCompact = (1 << 0), // Key saved without spaces
+    ProtoPirateDecodeResultFlagPresetRaw = (1 << 1), // Preset saved by its short name
+} ProtoPirateDecodeResultFlag;
+
+// What a decoder recovered from the last frame, as plain data. Fields are in
+// the order the protocol serializes them, so a capture file can be rebuilt
+// from this alone.
+typedef struct {
+    uint64_t key;
+    uint32_t field_value[PROTOPIRATE_DECODE_FIELDS_MAX];
+    uint8_t field_id[PROTOPIRATE_DECODE_FIELDS_MAX];
+    uint8_t field_count;
+    uint8_t protocol_id; // Index into protopirate_protocol_registry
+    uint8_t bit_count;
+    uint8_t key_size; // Bytes
+    uint8_t flags;
+} ProtoPirateDecodeResult;
+
+static inline void protopirate_decode_result_add(
+    ProtoPirateDecodeResult* result,
+    ProtoPirateField field,
+    uint32_t value) {
+    if(result->field_count >= PROTOPIRATE_DECODE_FIELDS_MAX) return;
+    result->field_id[result->field_count] = field;
+    result->field_value[result->field_count++] = value;
+}
+
+static inline bool protopirate_decode_result_get(
+    const ProtoPirateDecodeResult* result,
+    ProtoPirateField field,
+    uint32_t* value) {
+    for(uint8_t i = 0; i < result->field_count; i++) {
+        if(result->field_id[i] == field) {
+            *value = result->field_value[i];
+            return true;
+        }
+    }
+    return false;
+}
+
+const char* protopirate_decode_field_name(uint8_t field);
@@ -513,6 +513,36 @@ SubGhzProtocolStatus subghz_protocol_decoder_ford_v0_serialize(
     return ret;
 }
 
+void subghz_protocol_decoder_ford_v0_get_result(void *context, ProtoPirateDecodeResult *result)
+{
+    furi_assert(context);
+    SubGhzProtocolDecoderFordV0 *instance = context;
+    result->key = instance->generic.data;
+    result->bit_count = instance->generic.data_count_bit;
+    result->key_size = sizeof(uint64_t);
+    protopirate_decode_result_add(result, ProtoPirateFieldBs, (instance->key2 >> 8) & 0xFF);
+    protopirate_decode_result_add(result, ProtoPirateFieldCrc, instance->key2 & 0xFF);
+    protopirate_decode_result_add(result, ProtoPirateFieldSerial, instance->serial);
+    protopirate_decode_result_add(result, ProtoPirateFieldBtn, instance->button);
+    protopirate_decode_result_add(result, ProtoPirateFieldCnt, instance->count);
+}
+
+uint16_t subghz_protocol_decoder_ford_v0_get_progress(void *context)
+{
+    furi_assert(context);
+    SubGhzProtocolDecoderFordV0 *instance = context;
+    switch (instance->decoder.parser_step)
+    {
+    case FordV0DecoderStepReset:
+        return 0;
+    case FordV0DecoderStepPreamble:
+    case FordV0DecoderStepPreambleCheck:
+        return MAX(instance->header_count, 1);
+    default:
+        return PROTOPIRATE_DECODER_PROGRESS_DATA;
+    }
+}
+
 SubGhzProtocolStatus subghz_protocol_decoder_ford_v0_deserialize(void *context, FlipperFormat *flipper_format)
 {
     furi_assert(context);
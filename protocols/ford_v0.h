@@ -11,6 +11,8 @@
 #include <flipper_format/flipper_format.h>
 #include <lib/toolbox/manchester_decoder.h>
 
+#include "decode_result.h"
+
 #define FORD_PROTOCOL_V0_NAME "Ford V0"
 
 extern const SubGhzProtocol ford_protocol_v0;
@@ -24,5 +26,7 @@ SubGhzProtocolStatus subghz_protocol_decoder_ford_v0_serialize(
     void* context,
     FlipperFormat* flipper_format,
     SubGhzRadioPreset* preset);
+void subghz_protocol_decoder_ford_v0_get_result(void* context, ProtoPirateDecodeResult* result);
+uint16_t subghz_protocol_decoder_ford_v0_get_progress(void* context);
 SubGhzProtocolStatus subghz_protocol_decoder_ford_v0_deserialize(void* context, FlipperFormat* flipper_format);
 void subghz_protocol_decoder_ford_v0_get_string(void* context, FuriString* output);
\ No newline at end of file
@@ -8,4 +8,6 @@
 #include <lib/subghz/blocks/encoder.h>
 #include <lib/subghz/blocks/generic.h>
 #include <lib/subghz/blocks/math.h>
-#include <flipper_format/flipper_format.h>
\ No newline at end of file
+#include <flipper_format/flipper_format.h>
+
+#include "decode_result.h"
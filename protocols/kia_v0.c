@@ -582,6 +582,37 @@ SubGhzProtocolStatus subghz_protocol_decoder_kia_serialize(
     return ret;
 }
 
+void subghz_protocol_decoder_kia_get_result(void *context, ProtoPirateDecodeResult *result)
+{
+    furi_assert(context);
+    SubGhzProtocolDecoderKIA *instance = context;
+    subghz_protocol_kia_check_remote_controller(&instance->generic);
+
+    // Saved with a compact key, a fixed bit count and the short preset name
+    result->key = instance->generic.data;
+    result->bit_count = 61;
+    result->key_size = sizeof(uint64_t);
+    result->flags = ProtoPirateDecodeResultFlagKeyCompact | ProtoPirateDecodeResultFlagPresetRaw;
+    protopirate_decode_result_add(result, ProtoPirateFieldSerial, instance->generic.serial);
+    protopirate_decode_result_add(result, ProtoPirateFieldBtn, instance->generic.btn);
+    protopirate_decode_result_add(result, ProtoPirateFieldCnt, instance->generic.cnt);
+}
+
+uint16_t subghz_protocol_decoder_kia_get_progress(void *context)
+{
+    furi_assert(context);
+    SubGhzProtocolDecoderKIA *instance = context;
+    switch (instance->decoder.parser_step)
+    {
+    case KIADecoderStepReset:
+        return 0;
+    case KIADecoderStepCheckPreambula:
+        return MAX(instance->header_count, 1);
+    default:
+        return PROTOPIRATE_DECODER_PROGRESS_DATA;
+    }
+}
+
 SubGhzProtocolStatus
 subghz_protocol_decoder_kia_deserialize(void *context, FlipperFormat *flipper_format)
 {
@@ -20,5 +20,7 @@ SubGhzProtocolStatus subghz_protocol_decoder_kia_serialize(
     void* context,
     FlipperFormat* flipper_format,
     SubGhzRadioPreset* preset);
+void subghz_protocol_decoder_kia_get_result(void* context, ProtoPirateDecodeResult* result);
+uint16_t subghz_protocol_decoder_kia_get_progress(void* context);
 SubGhzProtocolStatus subghz_protocol_decoder_kia_deserialize(void* context, FlipperFormat* flipper_format);
 void subghz_protocol_decoder_kia_get_string(void* context, FuriString* output);
\ No newline at end of file
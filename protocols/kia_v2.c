@@ -346,6 +346,36 @@ SubGhzProtocolStatus kia_protocol_decoder_v2_serialize(
     return ret;
 }
 
+void kia_protocol_decoder_v2_get_result(void *context, ProtoPirateDecodeResult *result)
+{
+    furi_assert(context);
+    SubGhzProtocolDecoderKiaV2 *instance = context;
+    result->key = instance->generic.data;
+    result->bit_count = instance->generic.data_count_bit;
+    result->key_size = sizeof(uint64_t);
+    protopirate_decode_result_add(result, ProtoPirateFieldCrc, instance->generic.data & 0x0F);
+    protopirate_decode_result_add(result, ProtoPirateFieldSerial, instance->generic.serial);
+    protopirate_decode_result_add(result, ProtoPirateFieldBtn, instance->generic.btn);
+    protopirate_decode_result_add(result, ProtoPirateFieldCnt, instance->generic.cnt);
+    protopirate_decode_result_add(
+        result, ProtoPirateFieldRawCnt, (instance->generic.data >> 4) & 0xFFF);
+}
+
+uint16_t kia_protocol_decoder_v2_get_progress(void *context)
+{
+    furi_assert(context);
+    SubGhzProtocolDecoderKiaV2 *instance = context;
+    switch (instance->decoder.parser_step)
+    {
+    case KiaV2DecoderStepReset:
+        return 0;
+    case KiaV2DecoderStepCheckPreamble:
+        return MAX(instance->header_count, 1);
+    default:
+        return PROTOPIRATE_DECODER_PROGRESS_DATA;
+    }
+}
+
 SubGhzProtocolStatus
 kia_protocol_decoder_v2_deserialize(void *context, FlipperFormat *flipper_format)
 {
@@ -412,6 +412,33 @@ SubGhzProtocolStatus kia_protocol_decoder_v3_v4_serialize(
     return ret;
 }
 
+void kia_protocol_decoder_v3_v4_get_result(void *context, ProtoPirateDecodeResult *result)
+{
+    furi_assert(context);
+    SubGhzProtocolDecoderKiaV3V4 *instance = context;
+    result->key = instance->generic.data;
+    result->bit_count = instance->generic.data_count_bit;
+    result->key_size = sizeof(uint64_t);
+    protopirate_decode_result_add(result, ProtoPirateFieldEncrypted, instance->encrypted);
+    protopirate_decode_result_add(result, ProtoPirateFieldDecrypted, instance->decrypted);
+    protopirate_decode_result_add(result, ProtoPirateFieldVersion, instance->version);
+}
+
+uint16_t kia_protocol_decoder_v3_v4_get_progress(void *context)
+{
+    furi_assert(context);
+    SubGhzProtocolDecoderKiaV3V4 *instance = context;
+    switch (instance->decoder.parser_step)
+    {
+    case KiaV3V4DecoderStepReset:
+        return 0;
+    case KiaV3V4DecoderStepCheckPreamble:
+        return MAX(instance->header_count, 1);
+    default:
+        return PROTOPIRATE_DECODER_PROGRESS_DATA;
+    }
+}
+
 SubGhzProtocolStatus
 kia_protocol_decoder_v3_v4_deserialize(void *context, FlipperFormat *flipper_format)
 {
@@ -369,6 +369,37 @@ SubGhzProtocolStatus kia_protocol_decoder_v5_serialize(
     return ret;
 }
 
+void kia_protocol_decoder_v5_get_result(void *context, ProtoPirateDecodeResult *result)
+{
+    furi_assert(context);
+    SubGhzProtocolDecoderKiaV5 *instance = context;
+    result->key = instance->generic.data;
+    result->bit_count = instance->generic.data_count_bit;
+    result->key_size = sizeof(uint64_t);
+    protopirate_decode_result_add(result, ProtoPirateFieldSerial, instance->generic.serial);
+    protopirate_decode_result_add(result, ProtoPirateFieldBtn, instance->generic.btn);
+    protopirate_decode_result_add(result, ProtoPirateFieldCnt, instance->generic.cnt);
+    protopirate_decode_result_add(
+        result, ProtoPirateFieldDataHi, (uint32_t)(instance->generic.data >> 32));
+    protopirate_decode_result_add(
+        result, ProtoPirateFieldDataLo, (uint32_t)(instance->generic.data & 0xFFFFFFFF));
+}
+
+uint16_t kia_protocol_decoder_v5_get_progress(void *context)
+{
+    furi_assert(context);
+    SubGhzProtocolDecoderKiaV5 *instance = context;
+    switch (instance->decoder.parser_step)
+    {
+    case KiaV5DecoderStepReset:
+        return 0;
+    case KiaV5DecoderStepCheckPreamble:
+        return MAX(instance->header_count, 1);
+    default:
+        return PROTOPIRATE_DECODER_PROGRESS_DATA;
+    }
+}
+
 SubGhzProtocolStatus
 kia_protocol_decoder_v5_deserialize(void *context, FlipperFormat *flipper_format)
 {
@@ -20,6 +20,8 @@ SubGhzProtocolStatus kia_protocol_decoder_v5_serialize(
     void* context,
     FlipperFormat* flipper_format,
     SubGhzRadioPreset* preset);
+void kia_protocol_decoder_v5_get_result(void* context, ProtoPirateDecodeResult* result);
+uint16_t kia_protocol_decoder_v5_get_progress(void* context);
 SubGhzProtocolStatus
     kia_protocol_decoder_v5_deserialize(void* context, FlipperFormat* flipper_format);
 void kia_protocol_decoder_v5_get_string(void* context, FuriString* output);
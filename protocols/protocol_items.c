@@ -16,3 +16,96 @@ const SubGhzProtocolRegistry protopirate_protocol_registry = {
     .items = protopirate_protocol_registry_items,
     .size = COUNT_OF(protopirate_protocol_registry_items),
 };
+
+typedef void (*ProtoPirateGetResult)(void* context, ProtoPirateDecodeResult* result);
+
+// Same order as protopirate_protocol_registry_items
+static const ProtoPirateGetResult protopirate_protocol_result_items[] = {
+    subghz_protocol_decoder_kia_get_result,
+    kia_protocol_decoder_v1_get_result,
+    kia_protocol_decoder_v2_get_result,
+    kia_protocol_decoder_v3_v4_get_result,
+    kia_protocol_decoder_v5_get_result,
+    subghz_protocol_decoder_ford_v0_get_result,
+    subghz_protocol_decoder_subaru_get_result,
+    subghz_protocol_decoder_suzuki_get_result,
+    subghz_protocol_decoder_vw_get_result,
+};
+
+typedef uint16_t (*ProtoPirateGetProgress)(void* context);
+
+// Same order as protopirate_protocol_registry_items
+static const ProtoPirateGetProgress protopirate_protocol_progress_items[] = {
+    subghz_protocol_decoder_kia_get_progress,
+    kia_protocol_decoder_v1_get_progress,
+    kia_protocol_decoder_v2_get_progress,
+    kia_protocol_decoder_v3_v4_get_progress,
+    kia_protocol_decoder_v5_get_progress,
+    subghz_protocol_decoder_ford_v0_get_progress,
+    subghz_protocol_decoder_subaru_get_progress,
+    subghz_protocol_decoder_suzuki_get_progress,
+    subghz_protocol_decoder_vw_get_progress,
+};
+
+static const char* const protopirate_decode_field_names[ProtoPirateFieldCount] = {
+    [ProtoPirateFieldSerial] = "Serial",
+    [ProtoPirateFieldBtn] = "Btn",
+    [ProtoPirateFieldCnt] = "Cnt",
+    [ProtoPirateFieldCrc] = "CRC",
+    [ProtoPirateFieldType] = "Type",
+    [ProtoPirateFieldBs] = "BS",
+    [ProtoPirateFieldEncrypted] = "Encrypted",
+    [ProtoPirateFieldDecrypted] = "Decrypted",
+    [ProtoPirateFieldVersion] = "Version",
+    [ProtoPirateFieldCheck] = "Check",
+    [ProtoPirateFieldDataHi] = "DataHi",
+    [ProtoPirateFieldDataLo] = "DataLo",
+    [ProtoPirateFieldRawCnt] = "RawCnt",
+};
+
+const char* protopirate_decode_field_name(uint8_t field) {
+    return (field < ProtoPirateFieldCount) ? protopirate_decode_field_names[field] : "Unknown";
+}
+
+const char* protopirate_protocol_get_name(uint8_t protocol_id) {
+    if(protocol_id >= COUNT_OF(protopirate_protocol_registry_items)) return "Unknown";
+    return protopirate_protocol_registry_items[protocol_id]->name;
+}
+
+bool protopirate_protocol_get_result(
+    SubGhzProtocolDecoderBase* decoder_base,
+    ProtoPirateDecodeResult* result) {
+    furi_assert(decoder_base);
+    furi_assert(result);
+    memset(result, 0, sizeof(ProtoPirateDecodeResult));
+    for(uint8_t i = 0; i < COUNT_OF(protopirate_protocol_registry_items); i++) {
+        if(protopirate_protocol_registry_items[i] != decoder_base->protocol) continue;
+        result->protocol_id = i;
+        protopirate_protocol_result_items[i](decoder_base, result);
+        return true;
+    }
+    return false;
+}
+
+uint32_t protopirate_protocol_get_mask(SubGhzProtocolFlag modulation, uint32_t disabled) {
+    uint32_t mask = 0;
+    for(uint8_t i = 0; i < COUNT_OF(protopirate_protocol_registry_items) && i < 32; i++) {
+        if(protopirate_protocol_registry_items[i]->flag & modulation) {
+            mask |= (1UL << i);
+        }
+    }
+    return mask & ~disabled;
+}
+
+uint16_t protopirate_protocol_get_progress(SubGhzProtocolDecoderBase* decoder_base) {
+    furi_assert(decoder_base);
+    for(uint8_t i = 0; i < COUNT_OF(protopirate_protocol_registry_items); i++) {
+        if(protopirate_protocol_registry_items[i] != decoder_base->protocol) continue;
+        return protopirate_protocol_progress_items[i](decoder_base);
+    }
+    return 0;
+}
+
+bool protopirate_protocol_is_busy(SubGhzProtocolDecoderBase* decoder_base) {
+    return protopirate_protocol_get_progress(decoder_base) >= PROTOPIRATE_DECODER_BUSY_HEADER;
+}
@@ -15,3 +15,17 @@
 #include "vw.h"
 
 extern const SubGhzProtocolRegistry protopirate_protocol_registry;
+
+// Plain-data view of the decoder's last frame; false for foreign protocols
+bool protopirate_protocol_get_result(
+    SubGhzProtocolDecoderBase* decoder_base,
+    ProtoPirateDecodeResult* result);
+const char* protopirate_protocol_get_name(uint8_t protocol_id);
+// How far the decoder is into a frame (see PROTOPIRATE_DECODER_PROGRESS_DATA).
+// Only reads its parser state, so it may be polled from another thread.
+uint16_t protopirate_protocol_get_progress(SubGhzProtocolDecoderBase* decoder_base);
+// True while the decoder is past the first few preamble pulses of a frame
+bool protopirate_protocol_is_busy(SubGhzProtocolDecoderBase* decoder_base);
+// Registry indices, as a bitmask, of the decoders worth running on a signal
+// of the given modulation (SubGhzProtocolFlag_AM and/or _FM), less disabled
+uint32_t protopirate_protocol_get_mask(SubGhzProtocolFlag modulation, uint32_t disabled);
@@ -519,6 +519,37 @@ SubGhzProtocolStatus subghz_protocol_decoder_subaru_serialize(
     return ret;
 }
 
+void subghz_protocol_decoder_subaru_get_result(void *context, ProtoPirateDecodeResult *result)
+{
+    furi_assert(context);
+    SubGhzProtocolDecoderSubaru *instance = context;
+    result->key = instance->generic.data;
+    result->bit_count = instance->generic.data_count_bit;
+    result->key_size = sizeof(uint64_t);
+    protopirate_decode_result_add(result, ProtoPirateFieldSerial, instance->serial);
+    protopirate_decode_result_add(result, ProtoPirateFieldBtn, instance->button);
+    protopirate_decode_result_add(result, ProtoPirateFieldCnt, instance->count);
+    protopirate_decode_result_add(
+        result, ProtoPirateFieldDataHi, (uint32_t)(instance->key >> 32));
+    protopirate_decode_result_add(
+        result, ProtoPirateFieldDataLo, (uint32_t)(instance->key & 0xFFFFFFFF));
+}
+
+uint16_t subghz_protocol_decoder_subaru_get_progress(void *context)
+{
+    furi_assert(context);
+    SubGhzProtocolDecoderSubaru *instance = context;
+    switch (instance->decoder.parser_step)
+    {
+    case SubaruDecoderStepReset:
+        return 0;
+    case SubaruDecoderStepCheckPreamble:
+        return MAX(instance->header_count, 1);
+    default:
+        return PROTOPIRATE_DECODER_PROGRESS_DATA;
+    }
+}
+
 SubGhzProtocolStatus subghz_protocol_decoder_subaru_deserialize(void *context, FlipperFormat *flipper_format)
 {
     furi_assert(context);
@@ -276,6 +276,35 @@ SubGhzProtocolStatus subghz_protocol_decoder_suzuki_serialize(
     return ret;
 }
 
+void subghz_protocol_decoder_suzuki_get_result(void *context, ProtoPirateDecodeResult *result)
+{
+    furi_assert(context);
+    SubGhzProtocolDecoderSuzuki *instance = context;
+    result->key = instance->generic.data;
+    result->bit_count = instance->generic.data_count_bit;
+    result->key_size = sizeof(uint64_t);
+    protopirate_decode_result_add(
+        result, ProtoPirateFieldCrc, (instance->generic.data >> 4) & 0xFF);
+    protopirate_decode_result_add(result, ProtoPirateFieldSerial, instance->generic.serial);
+    protopirate_decode_result_add(result, ProtoPirateFieldBtn, instance->generic.btn);
+    protopirate_decode_result_add(result, ProtoPirateFieldCnt, instance->generic.cnt);
+}
+
+uint16_t subghz_protocol_decoder_suzuki_get_progress(void *context)
+{
+    furi_assert(context);
+    SubGhzProtocolDecoderSuzuki *instance = context;
+    switch (instance->decoder.parser_step)
+    {
+    case SuzukiDecoderStepReset:
+        return 0;
+    case SuzukiDecoderStepFoundStartPulse:
+        return MAX(instance->header_count, 1);
+    default:
+        return PROTOPIRATE_DECODER_PROGRESS_DATA;
+    }
+}
+
 SubGhzProtocolStatus subghz_protocol_decoder_suzuki_deserialize(void *context, FlipperFormat *flipper_format)
 {
     furi_assert(context);
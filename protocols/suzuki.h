@@ -10,6 +10,8 @@
 #include <lib/subghz/blocks/math.h>
 #include <flipper_format/flipper_format.h>
 
+#include "decode_result.h"
+
 #define SUZUKI_PROTOCOL_NAME "Suzuki"
 
 extern const SubGhzProtocol suzuki_protocol;
@@ -23,5 +25,7 @@ SubGhzProtocolStatus subghz_protocol_decoder_suzuki_serialize(
     void* context,
     FlipperFormat* flipper_format,
     SubGhzRadioPreset* preset);
+void subghz_protocol_decoder_suzuki_get_result(void* context, ProtoPirateDecodeResult* result);
+uint16_t subghz_protocol_decoder_suzuki_get_progress(void* context);
 SubGhzProtocolStatus subghz_protocol_decoder_suzuki_deserialize(void* context, FlipperFormat* flipper_format);
 void subghz_protocol_decoder_suzuki_get_string(void* context, FuriString* output);
\ No newline at end of file
@@ -428,6 +428,34 @@ SubGhzProtocolStatus subghz_protocol_decoder_vw_serialize(
     return ret;
 }
 
+void subghz_protocol_decoder_vw_get_result(void *context, ProtoPirateDecodeResult *result)
+{
+    furi_assert(context);
+    SubGhzProtocolDecoderVw *instance = context;
+    result->key = instance->generic.data;
+    result->bit_count = instance->generic.data_count_bit;
+    result->key_size = sizeof(uint64_t);
+    uint32_t check = instance->data_2 & 0xFF;
+    protopirate_decode_result_add(result, ProtoPirateFieldType, (instance->data_2 >> 8) & 0xFF);
+    protopirate_decode_result_add(result, ProtoPirateFieldCheck, check);
+    protopirate_decode_result_add(result, ProtoPirateFieldBtn, (check >> 4) & 0xF);
+}
+
+uint16_t subghz_protocol_decoder_vw_get_progress(void *context)
+{
+    furi_assert(context);
+    SubGhzProtocolDecoderVw *instance = context;
+    switch (instance->decoder.parser_step)
+    {
+    case VwDecoderStepReset:
+        return 0;
+    case VwDecoderStepFoundSync:
+        return 1; // No preamble count kept
+    default:
+        return PROTOPIRATE_DECODER_PROGRESS_DATA;
+    }
+}
+
 SubGhzProtocolStatus subghz_protocol_decoder_vw_deserialize(void *context, FlipperFormat *flipper_format)
 {
     furi_assert(context);
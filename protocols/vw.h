@@ -11,6 +11,8 @@
 #include <lib/toolbox/manchester_decoder.h>
 #include <flipper_format/flipper_format.h>
 
+#include "decode_result.h"
+
 #define VW_PROTOCOL_NAME "VW"
 
 extern const SubGhzProtocol vw_protocol;
@@ -24,5 +26,7 @@ SubGhzProtocolStatus subghz_protocol_decoder_vw_serialize(
     void* context,
     FlipperFormat* flipper_format,
     SubGhzRadioPreset* preset);
+void subghz_protocol_decoder_vw_get_result(void* context, ProtoPirateDecodeResult* result);
+uint16_t subghz_protocol_decoder_vw_get_progress(void* context);
 SubGhzProtocolStatus subghz_protocol_decoder_vw_deserialize(void* context, FlipperFormat* flipper_format);
 void subghz_protocol_decoder_vw_get_string(void* context, FuriString* output);
\ No newline at end of file
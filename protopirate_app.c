@@ -73,6 +73,11 @@ ProtoPirateApp *protopirate_app_alloc()
     view_dispatcher_add_view(
         app->view_dispatcher, ProtoPirateViewWidget, widget_get_view(app->widget));
 
+    // Text Input
+    app->text_input = text_input_alloc();
+    view_dispatcher_add_view(
+        app->view_dispatcher, ProtoPirateViewTextInput, text_input_get_view(app->text_input));
+
     // About View
     app->view_about = view_alloc();
     view_dispatcher_add_view(app->view_dispatcher, ProtoPirateViewAbout, app->view_about);
@@ -94,6 +99,9 @@ ProtoPirateApp *protopirate_app_alloc()
     // Init setting
     app->setting = subghz_setting_alloc();
     app->loaded_file_path = NULL;
+    app->loaded_file_index = 0;
+    protopirate_capture_filter_reset(&app->capture_filter);
+    app->filter_serial_text[0] = '\0';
     // Fix: Load default settings first to ensure presets are available
     subghz_setting_load(app->setting, EXT_PATH("subghz/assets/setting.txt"));
     // Optionally load user settings if needed, but default is critical for presets
@@ -105,12 +113,21 @@ ProtoPirateApp *protopirate_app_alloc()
     
     // Apply auto-save setting
     app->auto_save = settings.auto_save;
+    app->session_mode = settings.session_log;
+    app->protocols_disabled = settings.protocols_disabled;
+    app->pulse_buffer = settings.pulse_buffer;
+    app->save_raw = settings.save_raw;
+    app->session_log = protopirate_session_log_alloc();
 
     // Init Worker & Protocol & History
     app->lock = ProtoPirateLockOff;
     app->txrx = malloc(sizeof(ProtoPirateTxRx));
     app->txrx->preset = malloc(sizeof(SubGhzRadioPreset));
     app->txrx->preset->name = furi_string_alloc();
+    app->txrx->rx_preset = malloc(sizeof(SubGhzRadioPreset));
+    app->txrx->rx_preset->name = furi_string_alloc();
+    app->txrx->rx_tune_head = 0;
+    app->txrx->rx_tune_tail = 0;
     app->txrx->txrx_state = ProtoPirateTxRxStateIDLE;
     app->txrx->rx_key_state = ProtoPirateRxKeyStateIDLE;
 
@@ -152,10 +169,19 @@ ProtoPirateApp *protopirate_app_alloc()
         ProtoPirateHopperStateRunning : ProtoPirateHopperStateOFF;
     app->txrx->hopper_idx_frequency = 0;
     app->txrx->hopper_timeout = 0;
+    app->txrx->hopper_holdoff = 0;
+    app->txrx->decoder_reset_pending = false;
+    app->txrx->overrun_resets = 0;
+    app->txrx->hopper_modulation = settings.hopping_modulation;
+    app->txrx->hopper_preset = PROTOPIRATE_HOPPER_PRESET_KEEP;
     app->txrx->idx_menu_chosen = 0;
 
+    app->txrx->hopper = protopirate_hopper_alloc(app->setting);
+    protopirate_hopper_set_modulation(app->txrx->hopper, app->txrx->hopper_modulation);
     app->txrx->history = protopirate_history_alloc();
-    app->txrx->worker = subghz_worker_alloc();
+    protopirate_history_load(app->txrx->history);
+    app->txrx->worker = protopirate_worker_alloc(settings.pulse_buffer);
+    app->txrx->pulses = protopirate_pulse_ring_alloc();
 
     // Create environment with our custom protocols
     app->txrx->environment = subghz_environment_alloc();
@@ -167,6 +193,17 @@ ProtoPirateApp *protopirate_app_alloc()
     // Create receiver
     app->txrx->receiver = subghz_receiver_alloc_init(app->txrx->environment);
 
+    // Keep the decoder instances at hand so the worker can feed them directly
+    // and their state can be polled cheaply
+    app->txrx->decoder_count =
+        MIN(protopirate_protocol_registry.size, (size_t)PROTOPIRATE_DECODERS_MAX);
+    for (size_t i = 0; i < app->txrx->decoder_count; i++)
+    {
+        app->txrx->decoders[i] = subghz_receiver_search_decoder_base_by_name(
+            app->txrx->receiver, protopirate_protocol_registry.items[i]->name);
+    }
+    protopirate_update_decoder_mask(app, NULL);
+
     // Initialize SubGhz devices
     subghz_devices_init();
 
@@ -203,11 +240,10 @@ ProtoPirateApp *protopirate_app_alloc()
     subghz_receiver_set_filter(app->txrx->receiver, SubGhzProtocolFlag_Decodable);
 
     // Set up worker callbacks
-    subghz_worker_set_overrun_callback(
-        app->txrx->worker, (SubGhzWorkerOverrunCallback)subghz_receiver_reset);
-    subghz_worker_set_pair_callback(
-        app->txrx->worker, (SubGhzWorkerPairCallback)subghz_receiver_decode);
-    subghz_worker_set_context(app->txrx->worker, app->txrx->receiver);
+    protopirate_worker_set_overrun_callback(app->txrx->worker, protopirate_rx_overrun_callback);
+    protopirate_worker_set_marker_callback(app->txrx->worker, protopirate_rx_marker_callback);
+    protopirate_worker_set_batch_callback(app->txrx->worker, protopirate_rx_batch_callback);
+    protopirate_worker_set_context(app->txrx->worker, app->txrx);
 
     furi_hal_power_suppress_charge_enter();
 
@@ -229,7 +265,12 @@ void protopirate_app_free(ProtoPirateApp *app)
     ProtoPirateSettings settings;
     settings.frequency = app->txrx->preset->frequency;
     settings.auto_save = app->auto_save;
+    settings.session_log = app->session_mode;
     settings.hopping_enabled = (app->txrx->hopper_state != ProtoPirateHopperStateOFF);
+    settings.hopping_modulation = app->txrx->hopper_modulation;
+    settings.protocols_disabled = app->protocols_disabled;
+    settings.pulse_buffer = app->pulse_buffer;
+    settings.save_raw = app->save_raw;
     
     // Find current preset index
     settings.preset_index = 0;
@@ -249,8 +290,8 @@ void protopirate_app_free(ProtoPirateApp *app)
     // Make sure we're not receiving
     if (app->txrx->txrx_state == ProtoPirateTxRxStateRx)
     {
-        subghz_worker_stop(app->txrx->worker);
         subghz_devices_stop_async_rx(app->txrx->radio_device);
+        protopirate_worker_stop(app->txrx->worker);
     }
 
     if (app->loaded_file_path)
@@ -258,6 +299,9 @@ void protopirate_app_free(ProtoPirateApp *app)
         furi_string_free(app->loaded_file_path);
     }
 
+    // Flushes and closes the log if a session is still open
+    protopirate_session_log_free(app->session_log);
+
     subghz_devices_sleep(app->txrx->radio_device);
     radio_device_loader_end(app->txrx->radio_device);
 
@@ -275,6 +319,10 @@ void protopirate_app_free(ProtoPirateApp *app)
     view_dispatcher_remove_view(app->view_dispatcher, ProtoPirateViewAbout);
     view_free(app->view_about);
 
+    // Text Input
+    view_dispatcher_remove_view(app->view_dispatcher, ProtoPirateViewTextInput);
+    text_input_free(app->text_input);
+
     // Widget
     view_dispatcher_remove_view(app->view_dispatcher, ProtoPirateViewWidget);
     widget_free(app->widget);
@@ -293,10 +341,15 @@ void protopirate_app_free(ProtoPirateApp *app)
     // Worker & Protocol & History
     subghz_receiver_free(app->txrx->receiver);
     subghz_environment_free(app->txrx->environment);
+    protopirate_history_save(app->txrx->history);
     protopirate_history_free(app->txrx->history);
-    subghz_worker_free(app->txrx->worker);
+    protopirate_hopper_free(app->txrx->hopper);
+    protopirate_worker_free(app->txrx->worker);
+    protopirate_pulse_ring_free(app->txrx->pulses);
     furi_string_free(app->txrx->preset->name);
     free(app->txrx->preset);
+    furi_string_free(app->txrx->rx_preset->name);
+    free(app->txrx->rx_preset);
     free(app->txrx);
 
     // View dispatcher
@@ -1,5 +1,6 @@
 // protopirate_app_i.c
 #include "protopirate_app_i.h"
+#include "protocols/protocol_items.h"
 
 #define TAG "ProtoPirateTxRx"
 
@@ -48,6 +49,55 @@ bool protopirate_set_preset(ProtoPirateApp *app, const char *preset)
     return true;
 }
 
+// Preset data is (register, value) pairs ending in a 0,0 pair, then the PA
+// table; MDMCFG2 bits 6:4 hold the modulation format
+#define CC1101_MDMCFG2           0x12
+#define CC1101_MOD_FORMAT_MASK   0x70
+#define CC1101_MOD_FORMAT_ASK    0x30
+#define CC1101_PRESET_REGS_MAX   64
+
+SubGhzProtocolFlag protopirate_preset_get_modulation(const uint8_t *preset_data)
+{
+    if (preset_data)
+    {
+        for (size_t i = 0; i < CC1101_PRESET_REGS_MAX; i++)
+        {
+            uint8_t reg = preset_data[i * 2];
+            uint8_t value = preset_data[i * 2 + 1];
+            if (reg == 0 && value == 0)
+            {
+                break;
+            }
+            if (reg == CC1101_MDMCFG2)
+            {
+                return ((value & CC1101_MOD_FORMAT_MASK) == CC1101_MOD_FORMAT_ASK) ?
+                           SubGhzProtocolFlag_AM :
+                           SubGhzProtocolFlag_FM;
+            }
+        }
+    }
+    return SubGhzProtocolFlag_AM | SubGhzProtocolFlag_FM;
+}
+
+void protopirate_update_decoder_mask(ProtoPirateApp *app, const uint8_t *preset_data)
+{
+    furi_assert(app);
+    uint32_t mask = protopirate_protocol_get_mask(
+        protopirate_preset_get_modulation(preset_data), app->protocols_disabled);
+    for (uint8_t i = 0; i < PROTOPIRATE_DECODERS_MAX; i++)
+    {
+        if (i >= app->txrx->decoder_count || !app->txrx->decoders[i])
+        {
+            mask &= ~(1UL << i);
+        }
+    }
+    // Decoders dropped from the mask keep stale state; the pending reset
+    // clears it before they are fed again
+    __atomic_store_n(&app->txrx->decoder_mask, mask, __ATOMIC_RELEASE);
+    __atomic_store_n(&app->txrx->decoder_reset_pending, true, __ATOMIC_RELEASE);
+    FURI_LOG_D(TAG, "Decoder mask %08lX", mask);
+}
+
 void protopirate_get_frequency_modulation(
     ProtoPirateApp *app,
     FuriString *frequency,
@@ -74,6 +124,7 @@ void protopirate_begin(ProtoPirateApp *app, uint8_t *preset_data)
     subghz_devices_reset(app->txrx->radio_device);
     subghz_devices_idle(app->txrx->radio_device);
     subghz_devices_load_preset(app->txrx->radio_device, FuriHalSubGhzPresetCustom, preset_data);
+    protopirate_update_decoder_mask(app, preset_data);
     app->txrx->txrx_state = ProtoPirateTxRxStateIDLE;
 }
 
@@ -93,14 +144,152 @@ uint32_t protopirate_rx(ProtoPirateApp *app, uint32_t frequency)
     subghz_devices_flush_rx(app->txrx->radio_device);
     subghz_devices_set_rx(app->txrx->radio_device);
 
+    // Nothing is decoded yet, so the worker's preset can be set directly
+    furi_string_set(app->txrx->rx_preset->name, app->txrx->preset->name);
+    app->txrx->rx_preset->frequency = frequency;
+    app->txrx->rx_preset->data = app->txrx->preset->data;
+    app->txrx->rx_preset->data_size = app->txrx->preset->data_size;
+    app->txrx->rx_tune_tail = app->txrx->rx_tune_head;
+
     subghz_devices_start_async_rx(
-        app->txrx->radio_device, subghz_worker_rx_callback, app->txrx->worker);
+        app->txrx->radio_device, protopirate_worker_rx_callback, app->txrx->worker);
 
-    subghz_worker_start(app->txrx->worker);
+    protopirate_worker_start(app->txrx->worker);
     app->txrx->txrx_state = ProtoPirateTxRxStateRx;
     return value;
 }
 
+// Change frequency, and the preset registers unless preset is KEEP, while
+// async RX and the worker keep running. Decoders are not touched from this
+// thread: a marker queued behind the pulses heard so far has the worker reset
+// them and switch the frequency it records only once those are decoded.
+uint32_t protopirate_rx_retune(ProtoPirateApp *app, uint32_t frequency, uint8_t preset)
+{
+    furi_assert(app);
+    if (!subghz_devices_is_frequency_valid(app->txrx->radio_device, frequency))
+    {
+        furi_crash("ProtoPirate: Incorrect RX frequency.");
+    }
+    furi_assert(app->txrx->txrx_state == ProtoPirateTxRxStateRx);
+
+    uint32_t start = DWT->CYCCNT;
+    uint8_t *preset_data = NULL;
+    if (preset != PROTOPIRATE_HOPPER_PRESET_KEEP)
+    {
+        preset_data = subghz_setting_get_preset_data(app->setting, preset);
+    }
+    subghz_devices_idle(app->txrx->radio_device);
+    if (preset_data)
+    {
+        subghz_devices_load_preset(
+            app->txrx->radio_device, FuriHalSubGhzPresetCustom, preset_data);
+        protopirate_update_decoder_mask(app, preset_data);
+    }
+    uint32_t value = subghz_devices_set_frequency(app->txrx->radio_device, frequency);
+    subghz_devices_flush_rx(app->txrx->radio_device);
+    subghz_devices_set_rx(app->txrx->radio_device);
+
+    uint32_t head = app->txrx->rx_tune_head;
+    if (head - __atomic_load_n(&app->txrx->rx_tune_tail, __ATOMIC_ACQUIRE) <
+        PROTOPIRATE_RX_TUNES)
+    {
+        ProtoPirateRxTune *tune = &app->txrx->rx_tunes[head % PROTOPIRATE_RX_TUNES];
+        tune->frequency = frequency;
+        tune->preset_name = NULL;
+        if (preset_data)
+        {
+            tune->preset_name = subghz_setting_get_preset_name(app->setting, preset);
+            tune->preset_data = preset_data;
+            tune->preset_data_size = subghz_setting_get_preset_data_size(app->setting, preset);
+        }
+        __atomic_store_n(&app->txrx->rx_tune_head, head + 1, __ATOMIC_RELEASE);
+        protopirate_worker_mark(app->txrx->worker);
+    }
+    else
+    {
+        // Worker far behind: at least drop decoder state at its next batch
+        FURI_LOG_W(TAG, "Retune queue full");
+        __atomic_store_n(&app->txrx->decoder_reset_pending, true, __ATOMIC_RELEASE);
+    }
+
+    protopirate_hopper_add_latency(
+        app->txrx->hopper,
+        (DWT->CYCCNT - start) / furi_hal_cortex_instructions_per_microsecond());
+    return value;
+}
+
+// Pulses were lost here. A decoder still waiting for a frame has nothing to
+// lose, so only those partway through one are reset.
+void protopirate_rx_overrun_callback(void *context)
+{
+    ProtoPirateTxRx *txrx = context;
+    // Pulses either side of the gap do not belong to the same capture
+    protopirate_pulse_ring_reset(txrx->pulses);
+    uint32_t mask = __atomic_load_n(&txrx->decoder_mask, __ATOMIC_ACQUIRE);
+    while (mask)
+    {
+        SubGhzProtocolDecoderBase *decoder = txrx->decoders[__builtin_ctz(mask)];
+        if (protopirate_protocol_get_progress(decoder))
+        {
+            decoder->protocol->decoder->reset(decoder);
+            txrx->overrun_resets++;
+        }
+        mask &= mask - 1;
+    }
+}
+
+// Pulses from here on were heard after the oldest queued retune
+void protopirate_rx_marker_callback(void *context)
+{
+    ProtoPirateTxRx *txrx = context;
+    uint32_t tail = txrx->rx_tune_tail;
+    if (tail == __atomic_load_n(&txrx->rx_tune_head, __ATOMIC_ACQUIRE))
+    {
+        return;
+    }
+    const ProtoPirateRxTune *tune = &txrx->rx_tunes[tail % PROTOPIRATE_RX_TUNES];
+    txrx->rx_preset->frequency = tune->frequency;
+    if (tune->preset_name)
+    {
+        furi_string_set_str(txrx->rx_preset->name, tune->preset_name);
+        txrx->rx_preset->data = tune->preset_data;
+        txrx->rx_preset->data_size = tune->preset_data_size;
+    }
+    __atomic_store_n(&txrx->rx_tune_tail, tail + 1, __ATOMIC_RELEASE);
+
+    subghz_receiver_reset(txrx->receiver);
+    protopirate_pulse_ring_reset(txrx->pulses);
+}
+
+void protopirate_rx_batch_callback(void *context, const LevelDuration *pulses, size_t count)
+{
+    ProtoPirateTxRx *txrx = context;
+    if (__atomic_exchange_n(&txrx->decoder_reset_pending, false, __ATOMIC_ACQUIRE))
+    {
+        subghz_receiver_reset(txrx->receiver);
+        protopirate_pulse_ring_reset(txrx->pulses);
+    }
+    uint32_t first = protopirate_pulse_ring_push(txrx->pulses, pulses, count);
+    // Straight to the enabled decoders, each taking the whole batch in turn so
+    // its code and state stay hot; the rest cost nothing per pulse
+    uint32_t mask = __atomic_load_n(&txrx->decoder_mask, __ATOMIC_ACQUIRE);
+    while (mask)
+    {
+        SubGhzProtocolDecoderBase *decoder = txrx->decoders[__builtin_ctz(mask)];
+        SubGhzDecoderFeed feed = decoder->protocol->decoder->feed;
+        for (size_t i = 0; i < count; i++)
+        {
+            // A decode callback fired from feed reads this to find its pulses
+            txrx->pulse_trigger = first + i;
+            feed(
+                decoder,
+                level_duration_get_level(pulses[i]),
+                level_duration_get_duration(pulses[i]));
+        }
+        mask &= mask - 1;
+    }
+}
+
 void protopirate_idle(ProtoPirateApp *app)
 {
     furi_assert(app);
@@ -113,10 +302,11 @@ void protopirate_rx_end(ProtoPirateApp *app)
 {
     furi_assert(app);
     furi_assert(app->txrx->txrx_state == ProtoPirateTxRxStateRx);
-    if (subghz_worker_is_running(app->txrx->worker))
+    if (protopirate_worker_is_running(app->txrx->worker))
     {
-        subghz_worker_stop(app->txrx->worker);
+        // ISR first, so nothing lands in the ring after the worker clears it
         subghz_devices_stop_async_rx(app->txrx->radio_device);
+        protopirate_worker_stop(app->txrx->worker);
     }
     subghz_devices_idle(app->txrx->radio_device);
     app->txrx->txrx_state = ProtoPirateTxRxStateIDLE;
@@ -129,6 +319,28 @@ void protopirate_sleep(ProtoPirateApp *app)
     app->txrx->txrx_state = ProtoPirateTxRxStateSleep;
 }
 
+bool protopirate_rx_decoder_busy(ProtoPirateApp *app)
+{
+    furi_assert(app);
+    // Until the worker has reset them after a retune, decoders still hold
+    // whatever they had on the previous frequency
+    if (__atomic_load_n(&app->txrx->decoder_reset_pending, __ATOMIC_ACQUIRE) ||
+        __atomic_load_n(&app->txrx->rx_tune_tail, __ATOMIC_ACQUIRE) != app->txrx->rx_tune_head)
+    {
+        return false;
+    }
+    uint32_t mask = __atomic_load_n(&app->txrx->decoder_mask, __ATOMIC_ACQUIRE);
+    while (mask)
+    {
+        if (protopirate_protocol_is_busy(app->txrx->decoders[__builtin_ctz(mask)]))
+        {
+            return true;
+        }
+        mask &= mask - 1;
+    }
+    return false;
+}
+
 void protopirate_hopper_update(ProtoPirateApp *app)
 {
     furi_assert(app);
@@ -153,38 +365,79 @@ void protopirate_hopper_update(ProtoPirateApp *app)
     {
         rssi = subghz_devices_get_rssi(app->txrx->radio_device);
 
-        if (rssi > -90.0f)
+        if (protopirate_hopper_add_rssi(
+                app->txrx->hopper, app->txrx->hopper_idx_frequency, rssi))
         {
             app->txrx->hopper_timeout = 10;
             app->txrx->hopper_state = ProtoPirateHopperStateRSSITimeOut;
             return;
         }
+
+        // Frequencies with a record of captures are held for a few ticks
+        if (!protopirate_hopper_tick(app->txrx->hopper))
+        {
+            return;
+        }
     }
     else
     {
         app->txrx->hopper_state = ProtoPirateHopperStateRunning;
     }
 
-    if (app->txrx->hopper_idx_frequency <
-        subghz_setting_get_hopper_frequency_count(app->setting) - 1)
+    // Hold the hop while a frame is coming in, unless it has been held long
+    // enough that the frame must have ended or stalled
+    if (app->txrx->txrx_state == ProtoPirateTxRxStateRx &&
+        app->txrx->hopper_holdoff < PROTOPIRATE_HOPPER_HOLDOFF_TICKS &&
+        protopirate_rx_decoder_busy(app))
     {
-        app->txrx->hopper_idx_frequency++;
+        app->txrx->hopper_holdoff++;
+        return;
     }
-    else
+    app->txrx->hopper_holdoff = 0;
+
+    if (!protopirate_hopper_get_count(app->txrx->hopper))
+    {
+        return;
+    }
+    app->txrx->hopper_idx_frequency = protopirate_hopper_next(app->txrx->hopper);
+
+    uint32_t frequency =
+        protopirate_hopper_get_frequency(app->txrx->hopper, app->txrx->hopper_idx_frequency);
+
+    // Registers are only reloaded when the entry's preset differs from the
+    // one already in the radio. `preset` is only this thread's view; the
+    // worker takes the change from the retune queue.
+    uint8_t load = PROTOPIRATE_HOPPER_PRESET_KEEP;
+    uint8_t *preset_data = NULL;
+    uint8_t preset =
+        protopirate_hopper_get_preset(app->txrx->hopper, app->txrx->hopper_idx_frequency);
+    if (preset != PROTOPIRATE_HOPPER_PRESET_KEEP && preset != app->txrx->hopper_preset)
     {
-        app->txrx->hopper_idx_frequency = 0;
+        load = preset;
+        preset_data = subghz_setting_get_preset_data(app->setting, preset);
+        protopirate_preset_init(
+            app,
+            subghz_setting_get_preset_name(app->setting, preset),
+            frequency,
+            preset_data,
+            subghz_setting_get_preset_data_size(app->setting, preset));
+        app->txrx->hopper_preset = preset;
     }
 
     if (app->txrx->txrx_state == ProtoPirateTxRxStateRx)
     {
-        protopirate_rx_end(app);
+        app->txrx->preset->frequency = frequency;
+        protopirate_rx_retune(app, frequency, load);
     }
-    if (app->txrx->txrx_state == ProtoPirateTxRxStateIDLE)
+    else if (app->txrx->txrx_state == ProtoPirateTxRxStateIDLE)
     {
         subghz_receiver_reset(app->txrx->receiver);
-        app->txrx->preset->frequency =
-            subghz_setting_get_hopper_frequency(app->setting, app->txrx->hopper_idx_frequency);
-        protopirate_rx(app, app->txrx->preset->frequency);
+        app->txrx->preset->frequency = frequency;
+        if (preset_data)
+        {
+            protopirate_begin(app, preset_data);
+        }
+        protopirate_rx(app, frequency);
     }
 }
 
@@ -8,6 +8,11 @@
 #include "views/protopirate_receiver_info.h"
 #include "protopirate_history.h"
 #include "helpers/radio_device_loader.h"
+#include "helpers/protopirate_session_log.h"
+#include "helpers/protopirate_capture_index.h"
+#include "helpers/protopirate_hopper.h"
+#include "helpers/protopirate_worker.h"
+#include "helpers/protopirate_pulse_ring.h"
 
 #include <gui/gui.h>
 #include <gui/view_dispatcher.h>
@@ -15,30 +20,65 @@
 #include <gui/modules/submenu.h>
 #include <gui/modules/variable_item_list.h>
 #include <gui/modules/widget.h>
+#include <gui/modules/text_input.h>
 #include <notification/notification_messages.h>
 #include <lib/subghz/subghz_setting.h>
-#include <lib/subghz/subghz_worker.h>
 #include <lib/subghz/receiver.h>
 #include <lib/subghz/transmitter.h>
 #include <lib/subghz/devices/devices.h>
 #include <dialogs/dialogs.h>
 
+// Upper bound on decoders the receiver is built with; one bit each in a mask
+#define PROTOPIRATE_DECODERS_MAX 16
+
+// Retunes that can wait for the worker to reach their marker; hops come far
+// slower than the worker drains its ring
+#define PROTOPIRATE_RX_TUNES 8
+
 typedef struct ProtoPirateApp ProtoPirateApp;
 
+// What a retune changes in the preset decodes are recorded with. The preset
+// fields point into app->setting, which stays put while receiving.
+typedef struct
+{
+    uint32_t frequency;
+    const char *preset_name; // NULL keeps the preset
+    uint8_t *preset_data;
+    size_t preset_data_size;
+} ProtoPirateRxTune;
+
 typedef struct
 {
-    SubGhzWorker *worker;
+    ProtoPirateWorker *worker;
+    ProtoPiratePulseRing *pulses; // Recent pulses, worker thread only
+    uint32_t pulse_trigger; // Ring sequence of the pulse being fed to decoders
     SubGhzEnvironment *environment;
     SubGhzReceiver *receiver;
-    SubGhzRadioPreset *preset;
+    // Indexed like protopirate_protocol_registry; NULL if the receiver lacks it
+    SubGhzProtocolDecoderBase *decoders[PROTOPIRATE_DECODERS_MAX];
+    uint8_t decoder_count;
+    uint32_t decoder_mask; // Decoders the worker feeds, bit per decoders[] index
+    SubGhzRadioPreset *preset; // GUI thread; the worker never reads it
+    // Preset the pulses being decoded were heard with, which trails `preset`
+    // until the worker reaches a retune's marker. Worker thread while in Rx.
+    SubGhzRadioPreset *rx_preset;
+    ProtoPirateRxTune rx_tunes[PROTOPIRATE_RX_TUNES];
+    uint32_t rx_tune_head; // Written by retune
+    uint32_t rx_tune_tail; // Written by the worker
     ProtoPirateHistory *history;
+    ProtoPirateHopper *hopper;
     const SubGhzDevice *radio_device;
     ProtoPirateTxRxState txrx_state;
     ProtoPirateHopperState hopper_state;
     ProtoPirateRxKeyState rx_key_state;
     uint8_t hopper_idx_frequency;
     uint8_t hopper_timeout;
-    uint16_t idx_menu_chosen;
+    uint8_t hopper_holdoff; // Ticks the current hop has waited on a busy decoder
+    bool hopper_modulation; // Hop AM and FM presets as well as frequencies
+    uint8_t hopper_preset; // Preset the hopper switched to, or PRESET_KEEP
+    bool decoder_reset_pending; // Set by a retune, consumed by the worker
+    uint32_t overrun_resets; // Decoders reset because an overrun broke their frame
+    uint32_t idx_menu_chosen;
 } ProtoPirateTxRx;
 
 struct ProtoPirateApp
@@ -50,6 +90,7 @@ struct ProtoPirateApp
     VariableItemList *variable_item_list;
     Submenu *submenu;
     Widget *widget;
+    TextInput *text_input;
     View *view_about;
     ProtoPirateReceiver *protopirate_receiver;
     ProtoPirateReceiverInfo *protopirate_receiver_info;
@@ -57,7 +98,15 @@ struct ProtoPirateApp
     SubGhzSetting *setting;
     ProtoPirateLock lock;
     FuriString *loaded_file_path;
+    uint32_t loaded_file_index;
+    ProtoPirateCaptureFilter capture_filter;
+    char filter_serial_text[9];
     bool auto_save;
+    bool session_mode;
+    uint32_t protocols_disabled; // Bit per registry index, set in Receiver Config
+    uint32_t pulse_buffer; // Worker ring size in pulses, from the settings file
+    bool save_raw; // Append the capture's pulses as RAW_Data when saving to a file
+    ProtoPirateSessionLog *session_log;
     ProtoPirateSettings settings;
 };
 
@@ -69,6 +118,12 @@ void protopirate_preset_init(
     size_t preset_data_size);
 
 bool protopirate_set_preset(ProtoPirateApp *app, const char *preset);
+// SubGhzProtocolFlag_AM or _FM from the CC1101 modulation format in a preset
+// register list; both if it cannot be told
+SubGhzProtocolFlag protopirate_preset_get_modulation(const uint8_t *preset_data);
+// Narrow the decoders fed by the worker to those matching the preset and
+// not disabled
+void protopirate_update_decoder_mask(ProtoPirateApp *app, const uint8_t *preset_data);
 
 void protopirate_get_frequency_modulation(
     ProtoPirateApp *app,
@@ -77,9 +132,18 @@ void protopirate_get_frequency_modulation(
 
 void protopirate_begin(ProtoPirateApp *app, uint8_t *preset_data);
 uint32_t protopirate_rx(ProtoPirateApp *app, uint32_t frequency);
+// preset is an app->setting index, or PROTOPIRATE_HOPPER_PRESET_KEEP
+uint32_t protopirate_rx_retune(ProtoPirateApp *app, uint32_t frequency, uint8_t preset);
 void protopirate_idle(ProtoPirateApp *app);
 void protopirate_rx_end(ProtoPirateApp *app);
 void protopirate_sleep(ProtoPirateApp *app);
+// True if any decoder is partway through a frame
+bool protopirate_rx_decoder_busy(ProtoPirateApp *app);
 void protopirate_hopper_update(ProtoPirateApp *app);
 void protopirate_tx(ProtoPirateApp *app, uint32_t frequency);
+
+// ProtoPirateWorker callbacks; context is the app's ProtoPirateTxRx
+void protopirate_rx_overrun_callback(void *context);
+void protopirate_rx_marker_callback(void *context);
+void protopirate_rx_batch_callback(void *context, const LevelDuration *pulses, size_t count);
 void protopirate_tx_stop(ProtoPirateApp *app);
\ No newline at end of file
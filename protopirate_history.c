@@ -2,232 +2,1063 @@
 #include "protopirate_history.h"
 #include <lib/subghz/receiver.h>
 #include <flipper_format/flipper_format_i.h>
+#include <toolbox/stream/stream.h>
+#include <storage/storage.h>
+#include "helpers/protopirate_storage.h"
+#include "protocols/protocol_items.h"
 
 #define TAG "ProtoPirateHistory"
 
+// Preset blocks are shared by every record
+#define PROTOPIRATE_HISTORY_NAMES_MAX 48
+#define PROTOPIRATE_HISTORY_NAME_NONE 0xFF
+
+// Recently seen captures, keyed by a 64-bit fingerprint of protocol and key.
+// Open addressing with linear probing; a zero fingerprint marks a free slot.
+#define PROTOPIRATE_HISTORY_DEDUP_SLOTS 64
+#define PROTOPIRATE_HISTORY_DEDUP_MS    500
+
+typedef struct {
+    uint64_t fingerprint;
+    uint32_t expires;
+} ProtoPirateHistoryDedupSlot;
+
+// Hot window sizing: a share of the free heap at alloc, within these bounds
+#define PROTOPIRATE_HISTORY_HOT_MIN     32
+#define PROTOPIRATE_HISTORY_HOT_MAX     1024
+#define PROTOPIRATE_HISTORY_HEAP_SHARE  8
+#define PROTOPIRATE_HISTORY_HEAP_RESERVE (24 * 1024)
+// Spilled records are paged back in this many at a time
+#define PROTOPIRATE_HISTORY_PAGE_RECORDS 16
+
+// Fob table: entries in first-seen order, found through a small hash index
+#define PROTOPIRATE_HISTORY_FOB_SLOTS 128
+
+#define PROTOPIRATE_HISTORY_RAW_PULSES (PROTOPIRATE_HISTORY_RAW_PRE + PROTOPIRATE_HISTORY_RAW_POST)
+// RAW_Data values per line, as the SubGhz app writes them
+#define PROTOPIRATE_HISTORY_RAW_LINE 512
+
+// Pulses of one recent capture; count 0 marks a free slot
 typedef struct {
-    FuriString* item_str;
-    FlipperFormat* flipper_format;
-    uint8_t type;
-    SubGhzRadioPreset* preset;
-} ProtoPirateHistoryItem;
+    uint32_t seq;
+    uint16_t count;
+    int16_t pulses[PROTOPIRATE_HISTORY_RAW_PULSES];
+} ProtoPirateHistoryRaw;
 
-ARRAY_DEF(ProtoPirateHistoryItemArray, ProtoPirateHistoryItem, M_POD_OPLIST)
+// Everything needed to rebuild the serialized capture, in a fixed-size POD.
+// Display text and FlipperFormat are generated only when an item is opened.
+typedef struct {
+    ProtoPirateDecodeResult result;
+    uint32_t tick;
+    uint32_t frequency;
+    uint8_t preset_id;
+} ProtoPirateHistoryRecord;
 
+// Item idx < spilled lives in the spill file at record position idx; newer
+// items sit in the hot ring, records[head] being item `spilled`. Item 0
+// carries sequence number first_seq. Sequence numbers never repeat, so
+// callers can tell how far the window moved when old items are dropped.
+//
+// The radio worker is the only writer. Readers on the GUI thread copy what
+// they need under a seqlock (`version` is odd while an update is in flight)
+// and retry if it moved, so neither side ever blocks the other on RAM state.
 struct ProtoPirateHistory {
-    ProtoPirateHistoryItemArray_t data;
-    uint16_t last_index;
-    uint32_t last_update_timestamp;
-    uint8_t code_last_hash_data;
+    uint32_t version;
+    ProtoPirateHistoryRecord* records;
+    uint16_t hot_capacity;
+    uint16_t head;
+    uint16_t count;
+    uint32_t spilled;
+    uint32_t first_seq;
+
+    // Spill file I/O and its page cache, shared by the worker and GUI threads
+    FuriMutex* mutex;
+    Storage* storage;
+    File* spill;
+    bool spill_failed;
+    ProtoPirateHistoryRecord page[PROTOPIRATE_HISTORY_PAGE_RECORDS];
+    uint32_t page_start;
+    uint8_t page_count;
+
+    ProtoPirateHistoryDedupSlot dedup[PROTOPIRATE_HISTORY_DEDUP_SLOTS];
+    uint8_t dedup_used;
+    // Compaction runs on the worker thread, whose stack cannot spare a copy
+    ProtoPirateHistoryDedupSlot dedup_scratch[PROTOPIRATE_HISTORY_DEDUP_SLOTS];
+
+    ProtoPirateHistoryFob* fobs;
+    uint8_t fob_index[PROTOPIRATE_HISTORY_FOB_SLOTS]; // Fob position + 1, 0 if free
+    uint8_t fob_count;
+
+    FuriString* names[PROTOPIRATE_HISTORY_NAMES_MAX];
+    uint8_t name_count;
+
+    // Reused round-robin, so only the newest captures keep their pulses
+    ProtoPirateHistoryRaw raw[PROTOPIRATE_HISTORY_RAW_SLOTS];
+    uint8_t raw_next;
+
+    // Preset block of the last capture, rebuilt only when the preset changes
+    // (writer only)
+    FuriString* preset_name;
+    uint8_t preset_flags;
+    uint8_t preset_id;
+    FlipperFormat* scratch;
+    FuriString* line;
+    FuriString* preset_text;
 };
 
+static inline void protopirate_history_write_begin(ProtoPirateHistory* instance) {
+    __atomic_store_n(&instance->version, instance->version + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+static inline void protopirate_history_write_end(ProtoPirateHistory* instance) {
+    __atomic_store_n(&instance->version, instance->version + 1, __ATOMIC_RELEASE);
+}
+
+static inline uint32_t protopirate_history_read_begin(ProtoPirateHistory* instance) {
+    uint32_t version;
+    while((version = __atomic_load_n(&instance->version, __ATOMIC_ACQUIRE)) & 1) {
+        // Writer preempted mid-update; let it finish
+        furi_delay_tick(1);
+    }
+    return version;
+}
+
+static inline bool protopirate_history_read_retry(ProtoPirateHistory* instance, uint32_t version) {
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    return __atomic_load_n(&instance->version, __ATOMIC_RELAXED) != version;
+}
+
+static uint8_t protopirate_history_intern(ProtoPirateHistory* instance, const char* name) {
+    for(uint8_t i = 0; i < instance->name_count; i++) {
+        if(furi_string_equal_str(instance->names[i], name)) return i;
+    }
+    if(instance->name_count >= PROTOPIRATE_HISTORY_NAMES_MAX) {
+        FURI_LOG_W(TAG, "Name table full");
+        return PROTOPIRATE_HISTORY_NAME_NONE;
+    }
+    // Names are only ever appended; publish the slot before the count
+    uint8_t id = instance->name_count;
+    instance->names[id] = furi_string_alloc_set_str(name);
+    __atomic_store_n(&instance->name_count, id + 1, __ATOMIC_RELEASE);
+    return id;
+}
+
 ProtoPirateHistory* protopirate_history_alloc(void) {
     ProtoPirateHistory* instance = malloc(sizeof(ProtoPirateHistory));
-    ProtoPirateHistoryItemArray_init(instance->data);
-    instance->last_index = 0;
+
+    size_t free_heap = memmgr_get_free_heap();
+    size_t budget = (free_heap > PROTOPIRATE_HISTORY_HEAP_RESERVE) ?
+                        (free_heap - PROTOPIRATE_HISTORY_HEAP_RESERVE) /
+                            PROTOPIRATE_HISTORY_HEAP_SHARE :
+                        0;
+    size_t hot_capacity = budget / sizeof(ProtoPirateHistoryRecord);
+    instance->hot_capacity =
+        CLAMP(hot_capacity, PROTOPIRATE_HISTORY_HOT_MAX, PROTOPIRATE_HISTORY_HOT_MIN);
+    instance->records = malloc(sizeof(ProtoPirateHistoryRecord) * instance->hot_capacity);
+    FURI_LOG_I(TAG, "Hot window %u records", instance->hot_capacity);
+
+    instance->head = 0;
+    instance->count = 0;
+    instance->spilled = 0;
+    instance->first_seq = 0;
+    instance->mutex = furi_mutex_alloc(FuriMutexTypeNormal);
+    instance->storage = furi_record_open(RECORD_STORAGE);
+    instance->spill = NULL;
+    instance->spill_failed = false;
+    instance->page_start = 0;
+    instance->page_count = 0;
+    memset(instance->dedup, 0, sizeof(instance->dedup));
+    instance->dedup_used = 0;
+    instance->name_count = 0;
+    instance->scratch = flipper_format_string_alloc();
+    instance->line = furi_string_alloc();
+    instance->preset_text = furi_string_alloc();
+    instance->preset_name = furi_string_alloc();
+    instance->preset_id = PROTOPIRATE_HISTORY_NAME_NONE;
+    instance->fobs = malloc(sizeof(ProtoPirateHistoryFob) * PROTOPIRATE_HISTORY_FOBS_MAX);
+    memset(instance->fob_index, 0, sizeof(instance->fob_index));
+    instance->fob_count = 0;
+    memset(instance->raw, 0, sizeof(instance->raw));
+    instance->raw_next = 0;
     return instance;
 }
 
 void protopirate_history_free(ProtoPirateHistory* instance) {
     furi_assert(instance);
-    for(size_t i = 0; i < ProtoPirateHistoryItemArray_size(instance->data); i++) {
-        ProtoPirateHistoryItem* item = ProtoPirateHistoryItemArray_get(instance->data, i);
-        furi_string_free(item->item_str);
-        flipper_format_free(item->flipper_format);
-        if(item->preset) {
-            if(item->preset->name) {
-                furi_string_free(item->preset->name);
-            }
-            free(item->preset);
-        }
+    for(uint8_t i = 0; i < instance->name_count; i++) {
+        furi_string_free(instance->names[i]);
+    }
+    flipper_format_free(instance->scratch);
+    furi_string_free(instance->line);
+    furi_string_free(instance->preset_text);
+    furi_string_free(instance->preset_name);
+    free(instance->fobs);
+    free(instance->records);
+    if(instance->spill) {
+        storage_file_close(instance->spill);
+        storage_file_free(instance->spill);
+        storage_common_remove(instance->storage, PROTOPIRATE_HISTORY_SPILL_PATH);
     }
-    ProtoPirateHistoryItemArray_clear(instance->data);
+    furi_record_close(RECORD_STORAGE);
+    furi_mutex_free(instance->mutex);
     free(instance);
 }
 
 void protopirate_history_reset(ProtoPirateHistory* instance) {
     furi_assert(instance);
-    for(size_t i = 0; i < ProtoPirateHistoryItemArray_size(instance->data); i++) {
-        ProtoPirateHistoryItem* item = ProtoPirateHistoryItemArray_get(instance->data, i);
-        furi_string_free(item->item_str);
-        flipper_format_free(item->flipper_format);
-        if(item->preset) {
-            if(item->preset->name) {
-                furi_string_free(item->preset->name);
-            }
-            free(item->preset);
-        }
+    // Interned names are kept; the same protocols and presets come back
+    protopirate_history_write_begin(instance);
+    instance->first_seq += instance->spilled + instance->count;
+    instance->head = 0;
+    instance->count = 0;
+    instance->spilled = 0;
+    memset(instance->dedup, 0, sizeof(instance->dedup));
+    instance->dedup_used = 0;
+    memset(instance->fob_index, 0, sizeof(instance->fob_index));
+    instance->fob_count = 0;
+    protopirate_history_write_end(instance);
+
+    furi_mutex_acquire(instance->mutex, FuriWaitForever);
+    instance->page_count = 0;
+    if(instance->spill) {
+        storage_file_seek(instance->spill, 0, true);
+        storage_file_truncate(instance->spill);
     }
-    ProtoPirateHistoryItemArray_reset(instance->data);
-    instance->last_index = 0;
+    furi_mutex_release(instance->mutex);
 }
 
-uint16_t protopirate_history_get_item(ProtoPirateHistory* instance) {
+uint32_t protopirate_history_get_item(ProtoPirateHistory* instance) {
     furi_assert(instance);
-    return ProtoPirateHistoryItemArray_size(instance->data);
+    uint32_t version, items;
+    do {
+        version = protopirate_history_read_begin(instance);
+        items = instance->spilled + instance->count;
+    } while(protopirate_history_read_retry(instance, version));
+    return items;
 }
 
-uint16_t protopirate_history_get_last_index(ProtoPirateHistory* instance) {
+uint32_t protopirate_history_get_first_seq(ProtoPirateHistory* instance) {
     furi_assert(instance);
-    return instance->last_index;
+    return __atomic_load_n(&instance->first_seq, __ATOMIC_ACQUIRE);
+}
+
+// Position idx within the hot ring
+static ProtoPirateHistoryRecord*
+    protopirate_history_get_hot(ProtoPirateHistory* instance, uint16_t idx) {
+    uint32_t pos = (uint32_t)instance->head + idx;
+    if(pos >= instance->hot_capacity) pos -= instance->hot_capacity;
+    return &instance->records[pos];
 }
 
-// Helper function to free a single history item's resources
-static void protopirate_history_item_free(ProtoPirateHistoryItem* item) {
-    if(item->item_str) {
-        furi_string_free(item->item_str);
-        item->item_str = NULL;
+static bool protopirate_history_spill_open(ProtoPirateHistory* instance) {
+    if(instance->spill) return true;
+    if(instance->spill_failed) return false;
+
+    storage_simply_mkdir(instance->storage, PROTOPIRATE_APP_FOLDER);
+    instance->spill = storage_file_alloc(instance->storage);
+    if(!storage_file_open(
+           instance->spill, PROTOPIRATE_HISTORY_SPILL_PATH, FSAM_READ_WRITE, FSOM_CREATE_ALWAYS)) {
+        FURI_LOG_E(TAG, "Cannot open spill file");
+        storage_file_free(instance->spill);
+        instance->spill = NULL;
+        instance->spill_failed = true;
+        return false;
+    }
+    return true;
+}
+
+// Move the oldest hot record to the end of the spill file. Without a usable
+// file the spilled items are given up and the oldest hot record is dropped,
+// keeping item indices contiguous.
+static void protopirate_history_spill_oldest(ProtoPirateHistory* instance) {
+    ProtoPirateHistoryRecord* oldest = &instance->records[instance->head];
+    bool spilled = false;
+
+    // Records already in the file never change, so readers paging them in
+    // only contend with this append for the file handle
+    furi_mutex_acquire(instance->mutex, FuriWaitForever);
+    if(protopirate_history_spill_open(instance)) {
+        uint32_t offset = instance->spilled * sizeof(ProtoPirateHistoryRecord);
+        spilled = storage_file_seek(instance->spill, offset, true) &&
+                  storage_file_write(instance->spill, oldest, sizeof(ProtoPirateHistoryRecord)) ==
+                      sizeof(ProtoPirateHistoryRecord);
+        if(!spilled) {
+            FURI_LOG_E(TAG, "Spill write failed");
+            storage_file_close(instance->spill);
+            storage_file_free(instance->spill);
+            instance->spill = NULL;
+            instance->spill_failed = true;
+        }
     }
-    if(item->flipper_format) {
-        flipper_format_free(item->flipper_format);
-        item->flipper_format = NULL;
+    if(!spilled) instance->page_count = 0;
+    furi_mutex_release(instance->mutex);
+
+    protopirate_history_write_begin(instance);
+    if(spilled) {
+        instance->spilled++;
+    } else {
+        instance->first_seq += instance->spilled + 1;
+        instance->spilled = 0;
     }
-    if(item->preset) {
-        if(item->preset->name) {
-            furi_string_free(item->preset->name);
+    instance->head = (instance->head + 1) % instance->hot_capacity;
+    instance->count--;
+    protopirate_history_write_end(instance);
+}
+
+static bool protopirate_history_read_record(
+    ProtoPirateHistory* instance,
+    uint32_t idx,
+    ProtoPirateHistoryRecord* out) {
+    bool found, paged;
+    uint32_t version, spilled;
+
+    do {
+        version = protopirate_history_read_begin(instance);
+        spilled = instance->spilled;
+        paged = idx < spilled;
+        found = !paged && (idx - spilled < instance->count);
+        if(found) *out = *protopirate_history_get_hot(instance, idx - spilled);
+    } while(protopirate_history_read_retry(instance, version));
+
+    if(paged) {
+        furi_mutex_acquire(instance->mutex, FuriWaitForever);
+        if(idx < instance->page_start || idx >= instance->page_start + instance->page_count) {
+            // Page in the block holding idx
+            uint32_t start = idx - (idx % PROTOPIRATE_HISTORY_PAGE_RECORDS);
+            uint32_t want = MIN(spilled - start, PROTOPIRATE_HISTORY_PAGE_RECORDS);
+            uint32_t offset = start * sizeof(ProtoPirateHistoryRecord);
+            instance->page_count = 0;
+            if(instance->spill && storage_file_seek(instance->spill, offset, true)) {
+                size_t read = storage_file_read(
+                    instance->spill, instance->page, want * sizeof(ProtoPirateHistoryRecord));
+                instance->page_start = start;
+                instance->page_count = read / sizeof(ProtoPirateHistoryRecord);
+            }
         }
-        free(item->preset);
-        item->preset = NULL;
+        if(idx >= instance->page_start && idx < instance->page_start + instance->page_count) {
+            *out = instance->page[idx - instance->page_start];
+            found = true;
+        }
+        furi_mutex_release(instance->mutex);
     }
+
+    return found;
 }
 
-bool protopirate_history_add_to_history(
+// Preset lines exactly as the protocol's serializer writes them: the short
+// setting name for raw-preset protocols, otherwise the firmware preset name
+// plus the register dump for custom presets
+static uint8_t protopirate_history_preset_id(
     ProtoPirateHistory* instance,
-    void* context,
-    SubGhzRadioPreset* preset) {
-    furi_assert(instance);
-    furi_assert(context);
+    SubGhzRadioPreset* preset,
+    uint8_t flags) {
+    flags &= ProtoPirateDecodeResultFlagPresetRaw;
+    if(instance->preset_id != PROTOPIRATE_HISTORY_NAME_NONE && instance->preset_flags == flags &&
+       furi_string_equal(instance->preset_name, preset->name)) {
+        return instance->preset_id;
+    }
 
-    SubGhzProtocolDecoderBase* decoder_base = context;
+    FlipperFormat* ff = instance->scratch;
+    Stream* stream = flipper_format_get_raw_stream(ff);
+    stream_clean(stream);
+    if(flags & ProtoPirateDecodeResultFlagPresetRaw) {
+        flipper_format_write_string(ff, "Preset", preset->name);
+    } else {
+        FuriString* name = instance->line;
+        subghz_block_generic_get_preset_name(furi_string_get_cstr(preset->name), name);
+        flipper_format_write_string(ff, "Preset", name);
+        if(furi_string_equal_str(name, "FuriHalSubGhzPresetCustom")) {
+            flipper_format_write_string_cstr(ff, "Custom_preset_module", "CC1101");
+            flipper_format_write_hex(ff, "Custom_preset_data", preset->data, preset->data_size);
+        }
+    }
 
-    // Check for duplicate (same hash within 500ms)
-    if((instance->code_last_hash_data ==
-        subghz_protocol_decoder_base_get_hash_data(decoder_base)) &&
-       ((furi_get_tick() - instance->last_update_timestamp) < 500)) {
-        instance->last_update_timestamp = furi_get_tick();
-        return false;
+    furi_string_reset(instance->preset_text);
+    stream_rewind(stream);
+    while(stream_read_line(stream, instance->line)) {
+        furi_string_cat(instance->preset_text, instance->line);
+    }
+
+    instance->preset_id =
+        protopirate_history_intern(instance, furi_string_get_cstr(instance->preset_text));
+    instance->preset_flags = flags;
+    furi_string_set(instance->preset_name, preset->name);
+    return instance->preset_id;
+}
+
+static uint64_t protopirate_history_fingerprint(const ProtoPirateHistoryRecord* record) {
+    // FNV-1a over protocol, bit count and key
+    uint64_t hash = 0xCBF29CE484222325ULL;
+    uint8_t data[10];
+    data[0] = record->result.protocol_id;
+    data[1] = record->result.bit_count;
+    for(uint8_t i = 0; i < 8; i++) {
+        data[2 + i] = record->result.key >> (i * 8);
+    }
+    for(uint8_t i = 0; i < sizeof(data); i++) {
+        hash ^= data[i];
+        hash *= 0x100000001B3ULL;
+    }
+    return hash ? hash : 1;
+}
+
+static inline bool
+    protopirate_history_dedup_live(const ProtoPirateHistoryDedupSlot* slot, uint32_t now) {
+    return (int32_t)(slot->expires - now) > 0;
+}
+
+// Drop expired slots so probe chains stay short
+static void protopirate_history_dedup_compact(ProtoPirateHistory* instance, uint32_t now) {
+    ProtoPirateHistoryDedupSlot* live = instance->dedup_scratch;
+    uint8_t live_count = 0;
+    for(uint8_t i = 0; i < PROTOPIRATE_HISTORY_DEDUP_SLOTS; i++) {
+        if(instance->dedup[i].fingerprint &&
+           protopirate_history_dedup_live(&instance->dedup[i], now)) {
+            live[live_count++] = instance->dedup[i];
+        }
     }
 
-    // If history is full, remove the oldest entry
-    if(ProtoPirateHistoryItemArray_size(instance->data) >= KIA_HISTORY_MAX) {
-        ProtoPirateHistoryItem* oldest = ProtoPirateHistoryItemArray_get(instance->data, 0);
-        if(oldest) {
-            protopirate_history_item_free(oldest);
+    memset(instance->dedup, 0, sizeof(instance->dedup));
+    for(uint8_t i = 0; i < live_count; i++) {
+        uint8_t pos = live[i].fingerprint % PROTOPIRATE_HISTORY_DEDUP_SLOTS;
+        while(instance->dedup[pos].fingerprint) {
+            pos = (pos + 1) % PROTOPIRATE_HISTORY_DEDUP_SLOTS;
         }
-        ProtoPirateHistoryItemArray_pop_at(NULL, instance->data, 0);
-        FURI_LOG_D(TAG, "History full, removed oldest entry");
+        instance->dedup[pos] = live[i];
     }
+    instance->dedup_used = live_count;
+}
 
-    instance->code_last_hash_data = subghz_protocol_decoder_base_get_hash_data(decoder_base);
-    instance->last_update_timestamp = furi_get_tick();
+// Returns true if the fingerprint was seen within the window; either way the
+// entry's expiry is pushed out, so a held button stays suppressed.
+static bool protopirate_history_dedup_check(
+    ProtoPirateHistory* instance,
+    uint64_t fingerprint,
+    uint32_t now) {
+    uint32_t expires = now + PROTOPIRATE_HISTORY_DEDUP_MS;
+    uint8_t pos = fingerprint % PROTOPIRATE_HISTORY_DEDUP_SLOTS;
+    ProtoPirateHistoryDedupSlot* reuse = NULL;
 
-    // Create a new history item
-    ProtoPirateHistoryItem* item = ProtoPirateHistoryItemArray_push_raw(instance->data);
-    item->item_str = furi_string_alloc();
-    item->flipper_format = flipper_format_string_alloc();
-    item->type = 0;
+    for(uint8_t probe = 0; probe < PROTOPIRATE_HISTORY_DEDUP_SLOTS; probe++) {
+        ProtoPirateHistoryDedupSlot* slot = &instance->dedup[pos];
+        if(!slot->fingerprint) {
+            if(!reuse) reuse = slot;
+            break;
+        }
+        if(slot->fingerprint == fingerprint) {
+            bool live = protopirate_history_dedup_live(slot, now);
+            slot->expires = expires;
+            return live;
+        }
+        if(!reuse && !protopirate_history_dedup_live(slot, now)) reuse = slot;
+        pos = (pos + 1) % PROTOPIRATE_HISTORY_DEDUP_SLOTS;
+    }
 
-    // Copy preset
-    item->preset = malloc(sizeof(SubGhzRadioPreset));
-    item->preset->frequency = preset->frequency;
-    item->preset->name = furi_string_alloc();
-    furi_string_set(item->preset->name, preset->name);
-    item->preset->data = preset->data;
-    item->preset->data_size = preset->data_size;
+    if(reuse) {
+        if(!reuse->fingerprint) instance->dedup_used++;
+        reuse->fingerprint = fingerprint;
+        reuse->expires = expires;
+    }
+
+    if(instance->dedup_used >= PROTOPIRATE_HISTORY_DEDUP_SLOTS * 3 / 4) {
+        protopirate_history_dedup_compact(instance, now);
+    }
+    return false;
+}
+
+static uint8_t protopirate_history_fob_slot(uint8_t protocol_id, uint32_t serial) {
+    return ((serial * 2654435761UL) ^ protocol_id) % PROTOPIRATE_HISTORY_FOB_SLOTS;
+}
+
+static void protopirate_history_fob_index_insert(ProtoPirateHistory* instance, uint8_t idx) {
+    ProtoPirateHistoryFob* fob = &instance->fobs[idx];
+    uint8_t pos = protopirate_history_fob_slot(fob->protocol_id, fob->serial);
+    while(instance->fob_index[pos]) {
+        pos = (pos + 1) % PROTOPIRATE_HISTORY_FOB_SLOTS;
+    }
+    instance->fob_index[pos] = idx + 1;
+}
 
-    // Get string representation
-    FuriString* text = furi_string_alloc();
-    subghz_protocol_decoder_base_get_string(decoder_base, text);
-    furi_string_set(item->item_str, text);
+static ProtoPirateHistoryFob* protopirate_history_fob_find(
+    ProtoPirateHistory* instance,
+    uint8_t protocol_id,
+    uint32_t serial) {
+    uint8_t pos = protopirate_history_fob_slot(protocol_id, serial);
+    while(instance->fob_index[pos]) {
+        ProtoPirateHistoryFob* fob = &instance->fobs[instance->fob_index[pos] - 1];
+        if(fob->protocol_id == protocol_id && fob->serial == serial) return fob;
+        pos = (pos + 1) % PROTOPIRATE_HISTORY_FOB_SLOTS;
+    }
+    return NULL;
+}
 
-    // Serialize to flipper format
-    subghz_protocol_decoder_base_serialize(decoder_base, item->flipper_format, preset);
-    
-    // Debug: Log what we're adding to history
-    flipper_format_rewind(item->flipper_format);
-    uint32_t debug_bit_count;
-    FuriString* debug_protocol = furi_string_alloc();
-    if (flipper_format_read_string(item->flipper_format, "Protocol", debug_protocol)) {
-        FURI_LOG_I(TAG, "History add - Protocol: %s", furi_string_get_cstr(debug_protocol));
+static ProtoPirateHistoryFob* protopirate_history_fob_add(
+    ProtoPirateHistory* instance,
+    uint8_t protocol_id,
+    uint32_t serial) {
+    uint8_t idx;
+    if(instance->fob_count < PROTOPIRATE_HISTORY_FOBS_MAX) {
+        idx = instance->fob_count++;
+        protopirate_history_fob_index_insert(instance, idx);
+    } else {
+        // Table full: reuse the fob seen least recently and reindex
+        idx = 0;
+        for(uint8_t i = 1; i < instance->fob_count; i++) {
+            if((int32_t)(instance->fobs[i].last_tick - instance->fobs[idx].last_tick) < 0) {
+                idx = i;
+            }
+        }
+        instance->fobs[idx].protocol_id = protocol_id;
+        instance->fobs[idx].serial = serial;
+        memset(instance->fob_index, 0, sizeof(instance->fob_index));
+        for(uint8_t i = 0; i < instance->fob_count; i++) {
+            protopirate_history_fob_index_insert(instance, i);
+        }
     }
-    flipper_format_rewind(item->flipper_format);
-    if (flipper_format_read_uint32(item->flipper_format, "Bit", &debug_bit_count, 1)) {
-        FURI_LOG_I(TAG, "History add - Bit count: %lu", debug_bit_count);
+
+    ProtoPirateHistoryFob* fob = &instance->fobs[idx];
+    memset(fob, 0, sizeof(ProtoPirateHistoryFob));
+    fob->protocol_id = protocol_id;
+    fob->serial = serial;
+    return fob;
+}
+
+static void protopirate_history_fob_update(
+    ProtoPirateHistory* instance,
+    const ProtoPirateHistoryRecord* record,
+    uint32_t seq) {
+    const ProtoPirateDecodeResult* result = &record->result;
+    uint32_t serial, btn, cnt;
+    // Protocols without a plain serial can't be told apart per fob
+    if(!protopirate_decode_result_get(result, ProtoPirateFieldSerial, &serial)) return;
+    bool has_btn = protopirate_decode_result_get(result, ProtoPirateFieldBtn, &btn);
+    bool has_cnt = protopirate_decode_result_get(result, ProtoPirateFieldCnt, &cnt);
+
+    ProtoPirateHistoryFob* fob =
+        protopirate_history_fob_find(instance, result->protocol_id, serial);
+    if(!fob) {
+        fob = protopirate_history_fob_add(instance, result->protocol_id, serial);
+        fob->first_tick = record->tick;
     }
-    furi_string_free(debug_protocol);
 
-    furi_string_free(text);
+    fob->last_tick = record->tick;
+    fob->last_seq = seq;
+    fob->frequency = record->frequency;
+    if(fob->presses < UINT16_MAX) fob->presses++;
 
-    instance->last_index++;
+    if(has_btn) {
+        fob->last_btn = btn;
+        if(fob->btn_presses[btn & 0x0F] < UINT16_MAX) fob->btn_presses[btn & 0x0F]++;
+        fob->flags |= ProtoPirateHistoryFobFlagBtn;
+    }
 
-    FURI_LOG_I(TAG, "Added item %u to history (size: %zu)",
-               instance->last_index,
-               ProtoPirateHistoryItemArray_size(instance->data));
+    if(has_cnt) {
+        if(fob->flags & ProtoPirateHistoryFobFlagCnt) {
+            int32_t delta = (int32_t)(cnt - fob->last_cnt);
+            fob->last_delta = delta;
+            if(delta > fob->max_delta) fob->max_delta = delta;
+        }
+        fob->last_cnt = cnt;
+        fob->flags |= ProtoPirateHistoryFobFlagCnt;
+    }
+}
 
-    return true;
+uint8_t protopirate_history_get_fob_count(ProtoPirateHistory* instance) {
+    furi_assert(instance);
+    return __atomic_load_n(&instance->fob_count, __ATOMIC_ACQUIRE);
 }
 
-void protopirate_history_get_text_item_menu(
+bool protopirate_history_get_fob(
+    ProtoPirateHistory* instance,
+    uint8_t idx,
+    ProtoPirateHistoryFob* out_fob) {
+    furi_assert(instance);
+    furi_assert(out_fob);
+    uint32_t version;
+    bool found;
+    do {
+        version = protopirate_history_read_begin(instance);
+        found = idx < instance->fob_count;
+        if(found) *out_fob = instance->fobs[idx];
+    } while(protopirate_history_read_retry(instance, version));
+    return found;
+}
+
+void protopirate_history_get_text_fob_menu(
     ProtoPirateHistory* instance,
     FuriString* output,
-    uint16_t idx) {
+    uint8_t idx) {
     furi_assert(instance);
     furi_assert(output);
 
-    if(idx >= ProtoPirateHistoryItemArray_size(instance->data)) {
+    ProtoPirateHistoryFob fob_data;
+    if(!protopirate_history_get_fob(instance, idx, &fob_data)) {
         furi_string_set(output, "---");
         return;
     }
+    const ProtoPirateHistoryFob* fob = &fob_data;
+    furi_string_printf(
+        output,
+        "%s %lX x%u",
+        protopirate_protocol_get_name(fob->protocol_id),
+        fob->serial,
+        fob->presses);
+    if(fob->flags & ProtoPirateHistoryFobFlagCnt) {
+        furi_string_cat_printf(output, " +%ld", fob->last_delta);
+    }
+}
+
+bool protopirate_history_add_to_history(
+    ProtoPirateHistory* instance,
+    void* context,
+    SubGhzRadioPreset* preset) {
+    furi_assert(instance);
+    furi_assert(context);
+
+    SubGhzProtocolDecoderBase* decoder_base = context;
+    uint32_t now = furi_get_tick();
+
+    ProtoPirateHistoryRecord record;
+    memset(&record, 0, sizeof(ProtoPirateHistoryRecord));
+    if(!protopirate_protocol_get_result(decoder_base, &record.result)) {
+        FURI_LOG_E(TAG, "No decode result for %s", decoder_base->protocol->name);
+        return false;
+    }
+    record.tick = now;
+    record.frequency = preset->frequency;
 
-    ProtoPirateHistoryItem* item = ProtoPirateHistoryItemArray_get(instance->data, idx);
+    // Same protocol and key seen recently, whichever fob sent in between
+    if(protopirate_history_dedup_check(
+           instance, protopirate_history_fingerprint(&record), now)) {
+        return false;
+    }
 
-    // Get just the first line for the menu
-    const char* str = furi_string_get_cstr(item->item_str);
-    const char* newline = strchr(str, '\r');
-    if(newline) {
-        size_t len = newline - str;
-        furi_string_set_strn(output, str, len);
-    } else {
-        newline = strchr(str, '\n');
-        if(newline) {
-            size_t len = newline - str;
-            furi_string_set_strn(output, str, len);
-        } else {
-            furi_string_set(output, item->item_str);
-        }
+    // Hot window full: push its oldest record out to SD
+    if(instance->count >= instance->hot_capacity) {
+        protopirate_history_spill_oldest(instance);
+    }
+
+    record.preset_id = protopirate_history_preset_id(instance, preset, record.result.flags);
+
+    uint32_t seq = instance->first_seq + instance->spilled + instance->count;
+    protopirate_history_write_begin(instance);
+    *protopirate_history_get_hot(instance, instance->count) = record;
+    instance->count++;
+    protopirate_history_fob_update(instance, &record, seq);
+    protopirate_history_write_end(instance);
+
+    FURI_LOG_I(
+        TAG,
+        "Added %s %ubit to history (size: %lu)",
+        protopirate_protocol_get_name(record.result.protocol_id),
+        record.result.bit_count,
+        protopirate_history_get_item(instance));
+
+    return true;
+}
+
+void protopirate_history_get_text_item_menu(
+    ProtoPirateHistory* instance,
+    FuriString* output,
+    uint32_t idx) {
+    furi_assert(instance);
+    furi_assert(output);
+
+    ProtoPirateHistoryRecord record_data;
+    if(!protopirate_history_read_record(instance, idx, &record_data)) {
+        furi_string_set(output, "---");
+        return;
     }
+    const ProtoPirateHistoryRecord* record = &record_data;
+    furi_string_printf(
+        output,
+        "%s %dbit",
+        protopirate_protocol_get_name(record->result.protocol_id),
+        record->result.bit_count);
 }
 
 void protopirate_history_get_text_item(
     ProtoPirateHistory* instance,
     FuriString* output,
-    uint16_t idx) {
+    uint32_t idx) {
     furi_assert(instance);
     furi_assert(output);
 
-    if(idx >= ProtoPirateHistoryItemArray_size(instance->data)) {
+    ProtoPirateHistoryRecord record_data;
+    if(!protopirate_history_read_record(instance, idx, &record_data)) {
         furi_string_set(output, "---");
         return;
     }
+    const ProtoPirateHistoryRecord* record = &record_data;
+    const ProtoPirateDecodeResult* result = &record->result;
+    furi_string_printf(
+        output, "Key:%0*llX\r\n", result->key_size * 2, (unsigned long long)result->key);
+
+    for(uint8_t i = 0; i < result->field_count; i++) {
+        furi_string_cat_printf(
+            output,
+            "%s:%lX%s",
+            protopirate_decode_field_name(result->field_id[i]),
+            result->field_value[i],
+            (i & 1) ? "\r\n" : " ");
+    }
+    if(result->field_count & 1) furi_string_cat_str(output, "\r\n");
 
-    ProtoPirateHistoryItem* item = ProtoPirateHistoryItemArray_get(instance->data, idx);
-    furi_string_set(output, item->item_str);
+    furi_string_cat_printf(
+        output,
+        "Freq:%lu.%02lu MHz",
+        record->frequency / 1000000,
+        (record->frequency % 1000000) / 10000);
 }
 
 SubGhzProtocolDecoderBase*
-    protopirate_history_get_decoder_base(ProtoPirateHistory* instance, uint16_t idx) {
+    protopirate_history_get_decoder_base(ProtoPirateHistory* instance, uint32_t idx) {
     UNUSED(instance);
     UNUSED(idx);
     return NULL;
 }
 
-FlipperFormat* protopirate_history_get_raw_data(ProtoPirateHistory* instance, uint16_t idx) {
+bool protopirate_history_get_result(
+    ProtoPirateHistory* instance,
+    uint32_t idx,
+    ProtoPirateDecodeResult* out_result) {
+    furi_assert(instance);
+    furi_assert(out_result);
+
+    ProtoPirateHistoryRecord record;
+    if(!protopirate_history_read_record(instance, idx, &record)) return false;
+    *out_result = record.result;
+    return true;
+}
+
+bool protopirate_history_get_raw_data(
+    ProtoPirateHistory* instance,
+    uint32_t idx,
+    FlipperFormat* ff) {
+    furi_assert(instance);
+    furi_assert(ff);
+
+    ProtoPirateHistoryRecord record_data;
+    if(!protopirate_history_read_record(instance, idx, &record_data)) {
+        return false;
+    }
+    const ProtoPirateHistoryRecord* record = &record_data;
+    const ProtoPirateDecodeResult* result = &record->result;
+    Stream* stream = flipper_format_get_raw_stream(ff);
+    stream_clean(stream);
+
+    // Same key order the decoders serialize in
+    bool ok = false;
+    do {
+        if(!flipper_format_write_uint32(ff, "Frequency", &record->frequency, 1)) break;
+        if(record->preset_id < __atomic_load_n(&instance->name_count, __ATOMIC_ACQUIRE)) {
+            stream_write_string(stream, instance->names[record->preset_id]);
+        }
+        if(!flipper_format_write_string_cstr(
+               ff, "Protocol", protopirate_protocol_get_name(result->protocol_id)))
+            break;
+        uint32_t bit_count = result->bit_count;
+        if(!flipper_format_write_uint32(ff, "Bit", &bit_count, 1)) break;
+
+        if(result->flags & ProtoPirateDecodeResultFlagKeyCompact) {
+            char key_text[17];
+            snprintf(
+                key_text,
+                sizeof(key_text),
+                "%0*llX",
+                result->key_size * 2,
+                (unsigned long long)result->key);
+            if(!flipper_format_write_string_cstr(ff, "Key", key_text)) break;
+        } else {
+            uint8_t key_data[sizeof(uint64_t)];
+            for(uint8_t i = 0; i < result->key_size; i++) {
+                key_data[i] = result->key >> ((result->key_size - 1 - i) * 8);
+            }
+            if(!flipper_format_write_hex(ff, "Key", key_data, result->key_size)) break;
+        }
+
+        uint8_t i = 0;
+        for(; i < result->field_count; i++) {
+            if(!flipper_format_write_uint32(
+                   ff,
+                   protopirate_decode_field_name(result->field_id[i]),
+                   &result->field_value[i],
+                   1))
+                break;
+        }
+        ok = (i == result->field_count);
+    } while(false);
+
+    if(!ok) {
+        FURI_LOG_E(TAG, "Failed to rebuild item %lu", idx);
+        return false;
+    }
+
+    flipper_format_rewind(ff);
+    return true;
+}
+
+void protopirate_history_attach_raw(
+    ProtoPirateHistory* instance,
+    ProtoPiratePulseRing* ring,
+    uint32_t trigger) {
+    furi_assert(instance);
+    furi_assert(ring);
+    if(!instance->count) return;
+
+    // Sequence numbers never repeat, so a slot left over from a reset or an
+    // older item simply stops matching
+    ProtoPirateHistoryRaw* raw = &instance->raw[instance->raw_next];
+    protopirate_history_write_begin(instance);
+    raw->seq = instance->first_seq + instance->spilled + instance->count - 1;
+    raw->count = protopirate_pulse_ring_get_window(
+        ring, trigger, PROTOPIRATE_HISTORY_RAW_PRE, PROTOPIRATE_HISTORY_RAW_POST, raw->pulses);
+    protopirate_history_write_end(instance);
+    instance->raw_next = (instance->raw_next + 1) % PROTOPIRATE_HISTORY_RAW_SLOTS;
+}
+
+bool protopirate_history_append_raw_data(
+    ProtoPirateHistory* instance,
+    uint32_t idx,
+    FlipperFormat* ff) {
+    furi_assert(instance);
+    furi_assert(ff);
+
+    int16_t* pulses = malloc(sizeof(int16_t) * PROTOPIRATE_HISTORY_RAW_PULSES);
+    uint32_t version;
+    uint16_t count;
+    do {
+        version = protopirate_history_read_begin(instance);
+        count = 0;
+        uint32_t seq = instance->first_seq + idx;
+        for(uint8_t i = 0; i < PROTOPIRATE_HISTORY_RAW_SLOTS; i++) {
+            const ProtoPirateHistoryRaw* raw = &instance->raw[i];
+            if(raw->count && raw->seq == seq) {
+                count = raw->count;
+                memcpy(pulses, raw->pulses, sizeof(int16_t) * count);
+                break;
+            }
+        }
+    } while(protopirate_history_read_retry(instance, version));
+
+    bool ok = (count > 0);
+    if(ok) {
+        int32_t* line = malloc(sizeof(int32_t) * MIN(count, PROTOPIRATE_HISTORY_RAW_LINE));
+        stream_seek(flipper_format_get_raw_stream(ff), 0, StreamOffsetFromEnd);
+        for(uint16_t start = 0; ok && start < count; start += PROTOPIRATE_HISTORY_RAW_LINE) {
+            uint16_t n = MIN(count - start, PROTOPIRATE_HISTORY_RAW_LINE);
+            for(uint16_t i = 0; i < n; i++) {
+                line[i] = pulses[start + i];
+            }
+            ok = flipper_format_write_int32(ff, "RAW_Data", line, n);
+        }
+        free(line);
+        flipper_format_rewind(ff);
+    }
+    free(pulses);
+    return ok;
+}
+
+#define PROTOPIRATE_HISTORY_SNAPSHOT_MAGIC   0x53485050 // "PPHS"
+#define PROTOPIRATE_HISTORY_SNAPSHOT_VERSION 2
+
+// Snapshot layout: header, name table (uint16 length + bytes each), records
+// oldest first, then the fob table. Records and fobs are stored as-is, so a
+// restore is a handful of sequential reads.
+typedef struct {
+    uint32_t magic;
+    uint8_t version;
+    uint8_t name_count;
+    uint8_t fob_count;
+    uint8_t reserved;
+    uint16_t record_size;
+    uint16_t fob_size;
+    uint32_t record_count;
+    uint32_t first_seq;
+} ProtoPirateHistorySnapshotHeader;
+
+bool protopirate_history_save(ProtoPirateHistory* instance) {
+    furi_assert(instance);
+
+    File* file = storage_file_alloc(instance->storage);
+    bool ok = false;
+
+    furi_mutex_acquire(instance->mutex, FuriWaitForever);
+    do {
+        storage_simply_mkdir(instance->storage, PROTOPIRATE_APP_FOLDER);
+        if(!storage_file_open(
+               file, PROTOPIRATE_HISTORY_SNAPSHOT_PATH, FSAM_WRITE, FSOM_CREATE_ALWAYS))
+            break;
+
+        ProtoPirateHistorySnapshotHeader header = {
+            .magic = PROTOPIRATE_HISTORY_SNAPSHOT_MAGIC,
+            .version = PROTOPIRATE_HISTORY_SNAPSHOT_VERSION,
+            .name_count = instance->name_count,
+            .fob_count = instance->fob_count,
+            .reserved = 0,
+            .record_size = sizeof(ProtoPirateHistoryRecord),
+            .fob_size = sizeof(ProtoPirateHistoryFob),
+            .record_count = instance->spilled + instance->count,
+            .first_seq = instance->first_seq,
+        };
+        if(storage_file_write(file, &header, sizeof(header)) != sizeof(header)) break;
+
+        uint8_t i = 0;
+        for(; i < instance->name_count; i++) {
+            uint16_t len = furi_string_size(instance->names[i]);
+            if(storage_file_write(file, &len, sizeof(len)) != sizeof(len)) break;
+            if(storage_file_write(file, furi_string_get_cstr(instance->names[i]), len) != len)
+                break;
+        }
+        if(i != instance->name_count) break;
+
+        // Spilled records go through the page buffer
+        uint32_t copied = 0;
+        instance->page_count = 0;
+        if(instance->spilled && instance->spill) {
+            storage_file_seek(instance->spill, 0, true);
+            while(copied < instance->spilled) {
+                size_t want = MIN(instance->spilled - copied, PROTOPIRATE_HISTORY_PAGE_RECORDS) *
+                              sizeof(ProtoPirateHistoryRecord);
+                if(storage_file_read(instance->spill, instance->page, want) != want) break;
+                if(storage_file_write(file, instance->page, want) != want) break;
+                copied += want / sizeof(ProtoPirateHistoryRecord);
+            }
+        }
+        if(copied != instance->spilled) break;
+
+        // The hot ring in at most two contiguous runs
+        uint16_t first_run = MIN(instance->count, instance->hot_capacity - instance->head);
+        size_t size = first_run * sizeof(ProtoPirateHistoryRecord);
+        if(storage_file_write(file, &instance->records[instance->head], size) != size) break;
+        size = (instance->count - first_run) * sizeof(ProtoPirateHistoryRecord);
+        if(size && storage_file_write(file, instance->records, size) != size) break;
+
+        size = instance->fob_count * sizeof(ProtoPirateHistoryFob);
+        if(size && storage_file_write(file, instance->fobs, size) != size) break;
+
+        ok = true;
+    } while(false);
+    furi_mutex_release(instance->mutex);
+
+    storage_file_close(file);
+    storage_file_free(file);
+
+    if(!ok) {
+        FURI_LOG_E(TAG, "Snapshot save failed");
+        storage_common_remove(instance->storage, PROTOPIRATE_HISTORY_SNAPSHOT_PATH);
+    } else {
+        FURI_LOG_I(TAG, "Snapshot saved (%lu items)", protopirate_history_get_item(instance));
+    }
+    return ok;
+}
+
+bool protopirate_history_load(ProtoPirateHistory* instance) {
     furi_assert(instance);
 
-    if(idx >= ProtoPirateHistoryItemArray_size(instance->data)) {
-        return NULL;
+    File* file = storage_file_alloc(instance->storage);
+    bool ok = false;
+    char* name_buf = NULL;
+
+    protopirate_history_reset(instance);
+
+    furi_mutex_acquire(instance->mutex, FuriWaitForever);
+    do {
+        if(!storage_file_open(
+               file, PROTOPIRATE_HISTORY_SNAPSHOT_PATH, FSAM_READ, FSOM_OPEN_EXISTING))
+            break;
+
+        ProtoPirateHistorySnapshotHeader header;
+        if(storage_file_read(file, &header, sizeof(header)) != sizeof(header)) break;
+        if(header.magic != PROTOPIRATE_HISTORY_SNAPSHOT_MAGIC ||
+           header.version != PROTOPIRATE_HISTORY_SNAPSHOT_VERSION ||
+           header.record_size != sizeof(ProtoPirateHistoryRecord) ||
+           header.fob_size != sizeof(ProtoPirateHistoryFob) ||
+           header.name_count > PROTOPIRATE_HISTORY_NAMES_MAX ||
+           header.fob_count > PROTOPIRATE_HISTORY_FOBS_MAX) {
+            FURI_LOG_W(TAG, "Snapshot format mismatch");
+            break;
+        }
+
+        // Record ids refer to the saved name table, so it replaces ours
+        for(uint8_t i = 0; i < instance->name_count; i++) {
+            furi_string_free(instance->names[i]);
+        }
+        instance->name_count = 0;
+
+        uint8_t i = 0;
+        for(; i < header.name_count; i++) {
+            uint16_t len;
+            if(storage_file_read(file, &len, sizeof(len)) != sizeof(len)) break;
+            name_buf = realloc(name_buf, len + 1);
+            if(storage_file_read(file, name_buf, len) != len) break;
+            name_buf[len] = '\0';
+            instance->names[instance->name_count++] = furi_string_alloc_set_str(name_buf);
+        }
+        if(i != header.name_count) break;
+
+        // Anything beyond the hot window goes straight back to the spill file
+        uint32_t to_spill = (header.record_count > instance->hot_capacity) ?
+                                header.record_count - instance->hot_capacity :
+                                0;
+        bool spill_ok = !to_spill || protopirate_history_spill_open(instance);
+        uint32_t copied = 0;
+        while(copied < to_spill) {
+            size_t want = MIN(to_spill - copied, PROTOPIRATE_HISTORY_PAGE_RECORDS) *
+                          sizeof(ProtoPirateHistoryRecord);
+            if(storage_file_read(file, instance->page, want) != want) break;
+            if(spill_ok && storage_file_write(instance->spill, instance->page, want) != want) {
+                spill_ok = false;
+            }
+            copied += want / sizeof(ProtoPirateHistoryRecord);
+        }
+        if(copied != to_spill) break;
+
+        size_t size = (header.record_count - to_spill) * sizeof(ProtoPirateHistoryRecord);
+        if(storage_file_read(file, instance->records, size) != size) break;
+
+        size = header.fob_count * sizeof(ProtoPirateHistoryFob);
+        if(size && storage_file_read(file, instance->fobs, size) != size) break;
+
+        instance->first_seq = header.first_seq;
+        instance->spilled = to_spill;
+        if(!spill_ok) {
+            // Older part could not be kept; start the list at the hot window
+            instance->first_seq += to_spill;
+            instance->spilled = 0;
+        }
+        instance->head = 0;
+        instance->count = header.record_count - to_spill;
+        instance->page_count = 0;
+
+        instance->fob_count = header.fob_count;
+        for(uint8_t f = 0; f < instance->fob_count; f++) {
+            protopirate_history_fob_index_insert(instance, f);
+        }
+
+        ok = true;
+    } while(false);
+    furi_mutex_release(instance->mutex);
+
+    storage_file_close(file);
+    storage_file_free(file);
+    free(name_buf);
+
+    if(!ok) {
+        // Leave a clean, empty history behind
+        for(uint8_t i = 0; i < instance->name_count; i++) {
+            furi_string_free(instance->names[i]);
+        }
+        instance->name_count = 0;
+        protopirate_history_reset(instance);
     }
 
-    ProtoPirateHistoryItem* item = ProtoPirateHistoryItemArray_get(instance->data, idx);
-    return item->flipper_format;
-}
\ No newline at end of file
+    // Preset ids now refer to the restored table
+    instance->preset_id = PROTOPIRATE_HISTORY_NAME_NONE;
+
+    if(ok) {
+        FURI_LOG_I(TAG, "Snapshot restored (%lu items)", protopirate_history_get_item(instance));
+    }
+    return ok;
+}
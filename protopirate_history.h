@@ -3,16 +3,52 @@
 
 #include <lib/subghz/receiver.h>
 #include <lib/subghz/protocols/base.h>
+#include "protocols/decode_result.h"
+#include "helpers/protopirate_pulse_ring.h"
 
-#define KIA_HISTORY_MAX 50
+// Captures beyond the in-RAM window are appended here for the session
+#define PROTOPIRATE_HISTORY_SPILL_PATH EXT_PATH("subghz/protopirate/history.spill")
+// Whole history, written on exit and read back on start
+#define PROTOPIRATE_HISTORY_SNAPSHOT_PATH EXT_PATH("subghz/protopirate/history.bin")
+
+// Raw pulses are kept for this many of the newest captures, RAM only: up to
+// PRE pulses ending with the one that completed the decode, and POST after it
+#define PROTOPIRATE_HISTORY_RAW_SLOTS 4
+#define PROTOPIRATE_HISTORY_RAW_PRE   320
+#define PROTOPIRATE_HISTORY_RAW_POST  16
+
+// Distinct (protocol, serial) pairs tracked alongside the frame list
+#define PROTOPIRATE_HISTORY_FOBS_MAX 96
+
+typedef enum {
+    ProtoPirateHistoryFobFlagBtn = (1 << 0),
+    ProtoPirateHistoryFobFlagCnt = (1 << 1),
+} ProtoPirateHistoryFobFlag;
+
+typedef struct {
+    uint32_t serial;
+    uint32_t first_tick;
+    uint32_t last_tick;
+    uint32_t last_seq; // Most recent frame from this fob
+    uint32_t frequency;
+    uint32_t last_cnt;
+    int32_t last_delta; // Counter change between the last two presses
+    int32_t max_delta;
+    uint16_t presses;
+    uint16_t btn_presses[16];
+    uint8_t protocol_id;
+    uint8_t last_btn;
+    uint8_t flags;
+} ProtoPirateHistoryFob;
 
 typedef struct ProtoPirateHistory ProtoPirateHistory;
 
 ProtoPirateHistory* protopirate_history_alloc(void);
 void protopirate_history_free(ProtoPirateHistory* instance);
 void protopirate_history_reset(ProtoPirateHistory* instance);
-uint16_t protopirate_history_get_item(ProtoPirateHistory* instance);
-uint16_t protopirate_history_get_last_index(ProtoPirateHistory* instance);
+uint32_t protopirate_history_get_item(ProtoPirateHistory* instance);
+// Sequence number of item 0; item idx is first_seq + idx
+uint32_t protopirate_history_get_first_seq(ProtoPirateHistory* instance);
 bool protopirate_history_add_to_history(
     ProtoPirateHistory* instance,
     void* context,
@@ -20,11 +56,44 @@ bool protopirate_history_add_to_history(
 void protopirate_history_get_text_item_menu(
     ProtoPirateHistory* instance,
     FuriString* output,
-    uint16_t idx);
+    uint32_t idx);
 void protopirate_history_get_text_item(
     ProtoPirateHistory* instance,
     FuriString* output,
-    uint16_t idx);
+    uint32_t idx);
 SubGhzProtocolDecoderBase*
-    protopirate_history_get_decoder_base(ProtoPirateHistory* instance, uint16_t idx);
-FlipperFormat* protopirate_history_get_raw_data(ProtoPirateHistory* instance, uint16_t idx);
+    protopirate_history_get_decoder_base(ProtoPirateHistory* instance, uint32_t idx);
+bool protopirate_history_get_result(
+    ProtoPirateHistory* instance,
+    uint32_t idx,
+    ProtoPirateDecodeResult* out_result);
+// Rebuilds the item into ff (a string FlipperFormat owned by the caller)
+bool protopirate_history_get_raw_data(
+    ProtoPirateHistory* instance,
+    uint32_t idx,
+    FlipperFormat* ff);
+// Attach the pulses around ring sequence `trigger` to the newest item; call
+// from the worker right after a successful add
+void protopirate_history_attach_raw(
+    ProtoPirateHistory* instance,
+    ProtoPiratePulseRing* ring,
+    uint32_t trigger);
+// Append the item's pulses to ff as RAW_Data lines. False if it has none
+// (too old, or added before the receiver ran).
+bool protopirate_history_append_raw_data(
+    ProtoPirateHistory* instance,
+    uint32_t idx,
+    FlipperFormat* ff);
+
+uint8_t protopirate_history_get_fob_count(ProtoPirateHistory* instance);
+bool protopirate_history_get_fob(
+    ProtoPirateHistory* instance,
+    uint8_t idx,
+    ProtoPirateHistoryFob* out_fob);
+void protopirate_history_get_text_fob_menu(
+    ProtoPirateHistory* instance,
+    FuriString* output,
+    uint8_t idx);
+
+bool protopirate_history_save(ProtoPirateHistory* instance);
+bool protopirate_history_load(ProtoPirateHistory* instance);
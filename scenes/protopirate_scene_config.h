@@ -7,4 +7,5 @@ ADD_SCENE(protopirate, receiver_config, ReceiverConfig)
 ADD_SCENE(protopirate, receiver_info, ReceiverInfo)
 ADD_SCENE(protopirate, saved, Saved)
 ADD_SCENE(protopirate, saved_info, SavedInfo)
+ADD_SCENE(protopirate, saved_filter, SavedFilter)
 ADD_SCENE(protopirate, emulate, Emulate)
\ No newline at end of file
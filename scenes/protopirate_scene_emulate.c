@@ -11,6 +11,8 @@ typedef struct
     uint32_t current_counter;
     uint32_t serial;
     uint8_t original_button;
+    uint32_t frequency;
+    char preset[40];
     FuriString *protocol_name;
     FlipperFormat *flipper_format;
     SubGhzTransmitter *transmitter;
@@ -279,38 +281,75 @@ void protopirate_scene_emulate_on_enter(void *context)
     // Load the file
     if (app->loaded_file_path)
     {
-        FlipperFormat *ff = protopirate_storage_load_file(
-            furi_string_get_cstr(app->loaded_file_path));
+        const char *file_path = furi_string_get_cstr(app->loaded_file_path);
+        ProtoPirateCapture capture;
+        FlipperFormat *ff = NULL;
+
+        // Fields come from the typed loader; the file itself is only kept
+        // open for the transmitter
+        if (protopirate_storage_load_capture(file_path, &capture))
+        {
+            ff = protopirate_storage_load_file(file_path);
+        }
 
         if (ff)
         {
             emulate_context->flipper_format = ff;
 
-            // Read protocol name
-            flipper_format_rewind(ff);
-            if(!flipper_format_read_string(ff, "Protocol", emulate_context->protocol_name)) {
+            const ProtoPirateCaptureInfo *info = &capture.info;
+            if (info->protocol[0])
+            {
+                furi_string_set_str(emulate_context->protocol_name, info->protocol);
+            }
+            else
+            {
                 FURI_LOG_E(TAG, "Failed to read protocol name");
             }
 
-            // Read serial
-            flipper_format_rewind(ff);
-            if(!flipper_format_read_uint32(ff, "Serial", &emulate_context->serial, 1)) {
+            if (info->flags & ProtoPirateCaptureInfoFlagSerial)
+            {
+                emulate_context->serial = info->serial;
+            }
+            else
+            {
                 FURI_LOG_W(TAG, "Failed to read serial");
             }
 
-            // Read original button
-            flipper_format_rewind(ff);
-            uint32_t btn_temp;
-            if (flipper_format_read_uint32(ff, "Btn", &btn_temp, 1))
+            if (info->flags & ProtoPirateCaptureInfoFlagBtn)
             {
-                emulate_context->original_button = (uint8_t)btn_temp;
+                emulate_context->original_button = info->btn;
             }
 
-            // Read counter
+            // The counter must be the one in the file right now, never a
+            // cached copy, or a rolling code already sent goes out again
+            uint32_t cnt = 0;
             flipper_format_rewind(ff);
-            if (flipper_format_read_uint32(ff, "Cnt", &emulate_context->original_counter, 1))
+            if (flipper_format_read_uint32(ff, "Cnt", &cnt, 1))
             {
-                emulate_context->current_counter = emulate_context->original_counter;
+                emulate_context->original_counter = cnt;
+                emulate_context->current_counter = cnt;
+            }
+            flipper_format_rewind(ff);
+
+            emulate_context->frequency = 433920000;
+            if (info->flags & ProtoPirateCaptureInfoFlagFrequency)
+            {
+                emulate_context->frequency = info->frequency;
+            }
+            else
+            {
+                FURI_LOG_W(TAG, "Failed to read frequency, using default");
+            }
+
+            if (capture.preset[0])
+            {
+                strncpy(
+                    emulate_context->preset, capture.preset, sizeof(emulate_context->preset) - 1);
+            }
+            else
+            {
+                FURI_LOG_W(TAG, "Failed to read preset, using FM476");
+                strncpy(emulate_context->preset, "FM476", sizeof(emulate_context->preset) - 1);
             }
 
             // Set up transmitter based on protocol
@@ -448,22 +487,9 @@ bool protopirate_scene_emulate_on_event(void *context, SceneManagerEvent event)
                     break;
                 }
 
-                // Read frequency and preset from the saved file
-                uint32_t frequency = 433920000;
-                FuriString* preset_str = furi_string_alloc();
-                
-                flipper_format_rewind(emulate_context->flipper_format);
-                if(!flipper_format_read_uint32(emulate_context->flipper_format, "Frequency", &frequency, 1)) {
-                    FURI_LOG_W(TAG, "Failed to read frequency, using default");
-                }
-                
-                flipper_format_rewind(emulate_context->flipper_format);
-                if(!flipper_format_read_string(emulate_context->flipper_format, "Preset", preset_str)) {
-                    FURI_LOG_W(TAG, "Failed to read preset, using FM476");
-                    furi_string_set(preset_str, "FM476");
-                }
-                
-                const char* preset_name = furi_string_get_cstr(preset_str);
+                // Frequency and preset as loaded on enter
+                uint32_t frequency = emulate_context->frequency;
+                const char* preset_name = emulate_context->preset;
                 FURI_LOG_I(TAG, "Using frequency %lu Hz, preset %s", frequency, preset_name);
                 
                 // Get preset data
@@ -513,8 +539,6 @@ bool protopirate_scene_emulate_on_event(void *context, SceneManagerEvent event)
                     FURI_LOG_E(TAG, "No preset data available");
                     notification_message(app->notifications, &sequence_error);
                 }
-                
-                furi_string_free(preset_str);
             }
             else
             {
@@ -584,6 +608,8 @@ void protopirate_scene_emulate_on_exit(void *context)
         if (emulate_context->flipper_format)
         {
             flipper_format_free(emulate_context->flipper_format);
+            // Btn/Cnt may have been rewritten within one timestamp tick
+            protopirate_storage_forget_capture(furi_string_get_cstr(app->loaded_file_path));
         }
         furi_string_free(emulate_context->protocol_name);
         free(emulate_context);
@@ -1,38 +1,84 @@
 // scenes/protopirate_scene_receiver.c
 #include "../protopirate_app_i.h"
 #include "../helpers/protopirate_storage.h"
+#include "../protocols/protocol_items.h"
 #include <notification/notification_messages.h>
 
-#define TAG                     "ProtoPirateSceneRx"
-#define KIA_DISPLAY_HISTORY_MAX 50
+#define TAG "ProtoPirateSceneRx"
+
+// How long the status bar flags a capture overrun
+#define OVERRUN_INDICATOR_MS 3000
 
 // Forward declaration
 void protopirate_scene_receiver_view_callback(ProtoPirateCustomEvent event, void* context);
 
+// Inputs of the last status bar text; it is only rebuilt when one changes
+typedef struct {
+    uint32_t frequency;
+    char modulation[3]; // Shown as the first two letters of the preset
+    uint32_t items;
+    bool auto_save;
+    bool session_mode;
+    bool overrun; // Pulses were lost recently
+    bool valid;
+} ProtoPirateReceiverStatus;
+
+static ProtoPirateReceiverStatus g_status;
+static FuriString* g_frequency_str;
+static FuriString* g_modulation_str;
+static FuriString* g_history_stat_str;
+// Preset selected in Receiver Config, restored after modulation hopping
+static uint8_t g_home_preset;
+
 static void protopirate_scene_receiver_update_statusbar(void* context) {
     ProtoPirateApp* app = context;
-    FuriString* frequency_str = furi_string_alloc();
-    FuriString* modulation_str = furi_string_alloc();
-    FuriString* history_stat_str = furi_string_alloc();
+
+    ProtoPirateWorkerStats stats;
+    protopirate_worker_get_stats(app->txrx->worker, &stats);
+
+    ProtoPirateReceiverStatus status = {
+        .frequency = app->txrx->preset->frequency,
+        .items = protopirate_history_get_item(app->txrx->history),
+        .auto_save = app->auto_save,
+        .session_mode = app->session_mode,
+        .overrun = stats.overruns &&
+                   (furi_get_tick() - stats.overrun_tick) < furi_ms_to_ticks(OVERRUN_INDICATOR_MS),
+        .valid = true,
+    };
+    strncpy(status.modulation, furi_string_get_cstr(app->txrx->preset->name), 2);
+    if(g_status.valid && status.frequency == g_status.frequency &&
+       !strcmp(status.modulation, g_status.modulation) && status.items == g_status.items &&
+       status.auto_save == g_status.auto_save &&
+       status.session_mode == g_status.session_mode && status.overrun == g_status.overrun) {
+        return;
+    }
+    g_status = status;
+
+    FuriString* frequency_str = g_frequency_str;
+    FuriString* modulation_str = g_modulation_str;
+    FuriString* history_stat_str = g_history_stat_str;
 
     protopirate_get_frequency_modulation(app, frequency_str, modulation_str);
 
     // Check if using external radio
     bool is_external = radio_device_loader_is_external(app->txrx->radio_device);
 
-    // Show auto-save indicator in the history count area
+    // Show auto-save indicator in the history count area, prefixed with '!'
+    // while pulses are being lost to overruns
+    const char* overrun_flag = status.overrun ? "!" : "";
     if(app->auto_save) {
         furi_string_printf(
             history_stat_str,
-            "A%u/%u",
-            protopirate_history_get_item(app->txrx->history),
-            KIA_DISPLAY_HISTORY_MAX);
+            "%s%c%lu",
+            overrun_flag,
+            app->session_mode ? 'L' : 'A',
+            protopirate_history_get_item(app->txrx->history));
     } else {
         furi_string_printf(
             history_stat_str,
-            "%u/%u",
-            protopirate_history_get_item(app->txrx->history),
-            KIA_DISPLAY_HISTORY_MAX);
+            "%s%lu",
+            overrun_flag,
+            protopirate_history_get_item(app->txrx->history));
     }
 
     // Pass actual external radio status
@@ -42,10 +88,6 @@ static void protopirate_scene_receiver_update_statusbar(void* context) {
         furi_string_get_cstr(modulation_str),
         furi_string_get_cstr(history_stat_str),
         is_external);  // <-- Now correctly passes external status
-
-    furi_string_free(frequency_str);
-    furi_string_free(modulation_str);
-    furi_string_free(history_stat_str);
 }
 
 static void protopirate_scene_receiver_callback(
@@ -58,40 +100,56 @@ static void protopirate_scene_receiver_callback(
 
     FURI_LOG_I(TAG, "=== SIGNAL DECODED ===");
 
-    FuriString* str_buff = furi_string_alloc();
-    subghz_protocol_decoder_base_get_string(decoder_base, str_buff);
-    FURI_LOG_I(TAG, "%s", furi_string_get_cstr(str_buff));
+    // Credit the frequency it came in on, duplicates included
+    if(app->txrx->hopper_state != ProtoPirateHopperStateOFF) {
+        protopirate_hopper_add_hit(app->txrx->hopper, app->txrx->hopper_idx_frequency);
+    }
 
     // Add to history
-    if(protopirate_history_add_to_history(app->txrx->history, decoder_base, app->txrx->preset)) {
+    // Recorded with the preset the frame was heard on, not where the radio
+    // may have hopped to since
+    if(protopirate_history_add_to_history(
+           app->txrx->history, decoder_base, app->txrx->rx_preset)) {
+        // Still on the worker thread, inside the feed of the pulse that
+        // completed the frame
+        protopirate_history_attach_raw(
+            app->txrx->history, app->txrx->pulses, app->txrx->pulse_trigger);
         notification_message(app->notifications, &sequence_semi_success);
 
         FURI_LOG_I(
             TAG,
-            "Added to history, total items: %u",
+            "Added to history, total items: %lu",
             protopirate_history_get_item(app->txrx->history));
 
-        FuriString* item_name = furi_string_alloc();
-        protopirate_history_get_text_item_menu(
-            app->txrx->history, item_name, protopirate_history_get_item(app->txrx->history) - 1);
-
-        protopirate_view_receiver_add_item_to_menu(
-            app->protopirate_receiver, furi_string_get_cstr(item_name), 0);
-
-        furi_string_free(item_name);
+        protopirate_view_receiver_update_history(app->protopirate_receiver);
 
         // Auto-save if enabled
         if(app->auto_save) {
-            FlipperFormat* ff = protopirate_history_get_raw_data(
-                app->txrx->history, 
-                protopirate_history_get_item(app->txrx->history) - 1);
-            
-            if(ff) {
-                FuriString* protocol = furi_string_alloc();
-                flipper_format_rewind(ff);
-                if(!flipper_format_read_string(ff, "Protocol", protocol)) {
-                    furi_string_set_str(protocol, "Unknown");
+            uint32_t idx = protopirate_history_get_item(app->txrx->history) - 1;
+            FlipperFormat* ff = flipper_format_string_alloc();
+            bool have_data = protopirate_history_get_raw_data(app->txrx->history, idx, ff);
+
+            if(have_data && protopirate_session_log_is_open(app->session_log)) {
+                if(protopirate_session_log_append(
+                       app->session_log, ff, app->txrx->rx_preset->frequency)) {
+                    FURI_LOG_I(
+                        TAG,
+                        "Logged capture %lu",
+                        protopirate_session_log_get_count(app->session_log));
+                    notification_message(app->notifications, &sequence_double_vibro);
+                } else {
+                    FURI_LOG_E(TAG, "Session log append failed");
                 }
+            } else if(have_data) {
+                // Session log records are fixed size, so only files get pulses
+                if(app->save_raw) {
+                    protopirate_history_append_raw_data(app->txrx->history, idx, ff);
+                }
+                ProtoPirateDecodeResult result;
+                FuriString* protocol = furi_string_alloc_set_str(
+                    protopirate_history_get_result(app->txrx->history, idx, &result) ?
+                        protopirate_protocol_get_name(result.protocol_id) :
+                        "Unknown");
                 
                 // Clean protocol name for filename
                 furi_string_replace_all(protocol, "/", "_");
@@ -109,6 +167,8 @@ static void protopirate_scene_receiver_callback(
                 furi_string_free(protocol);
                 furi_string_free(saved_path);
             }
+
+            flipper_format_free(ff);
         }
 
         view_dispatcher_send_custom_event(
@@ -117,8 +177,6 @@ static void protopirate_scene_receiver_callback(
         FURI_LOG_W(TAG, "Failed to add to history (duplicate or full)");
     }
 
-    furi_string_free(str_buff);
-
     // Pause hopper when we receive something
     if(app->txrx->hopper_state == ProtoPirateHopperStateRunning) {
         app->txrx->hopper_state = ProtoPirateHopperStatePause;
@@ -140,12 +198,25 @@ void protopirate_scene_receiver_on_enter(void* context) {
     FURI_LOG_I(TAG, "Modulation: %s", furi_string_get_cstr(app->txrx->preset->name));
     FURI_LOG_I(TAG, "Auto-save: %s", app->auto_save ? "ON" : "OFF");
 
+    // Session mode appends every capture to one log instead of a file each
+    if(app->auto_save && app->session_mode) {
+        if(!protopirate_session_log_open(app->session_log)) {
+            FURI_LOG_E(TAG, "Session log unavailable, saving to files");
+        }
+    }
+
+    g_frequency_str = furi_string_alloc();
+    g_modulation_str = furi_string_alloc();
+    g_history_stat_str = furi_string_alloc();
+    memset(&g_status, 0, sizeof(g_status));
+
     // Set up the receiver callback
     subghz_receiver_set_rx_callback(app->txrx->receiver, protopirate_scene_receiver_callback, app);
 
     // Set up view callback
     protopirate_view_receiver_set_callback(
         app->protopirate_receiver, protopirate_scene_receiver_view_callback, app);
+    protopirate_view_receiver_set_history(app->protopirate_receiver, app->txrx->history);
 
     // Update status bar
     protopirate_scene_receiver_update_statusbar(app);
@@ -155,6 +226,34 @@ void protopirate_scene_receiver_on_enter(void* context) {
         app->txrx->hopper_state = ProtoPirateHopperStateRunning;
     }
 
+    uint32_t frequency = app->txrx->preset->frequency;
+    g_home_preset = PROTOPIRATE_HOPPER_PRESET_KEEP;
+    for(size_t i = 0; i < subghz_setting_get_preset_count(app->setting); i++) {
+        if(furi_string_equal_str(
+               app->txrx->preset->name, subghz_setting_get_preset_name(app->setting, i))) {
+            g_home_preset = i;
+            break;
+        }
+    }
+    app->txrx->hopper_preset = PROTOPIRATE_HOPPER_PRESET_KEEP;
+
+    if(app->txrx->hopper_state == ProtoPirateHopperStateRunning &&
+       protopirate_hopper_get_count(app->txrx->hopper)) {
+        uint8_t idx = protopirate_hopper_next(app->txrx->hopper);
+        uint8_t preset = protopirate_hopper_get_preset(app->txrx->hopper, idx);
+        app->txrx->hopper_idx_frequency = idx;
+        frequency = protopirate_hopper_get_frequency(app->txrx->hopper, idx);
+        if(preset != PROTOPIRATE_HOPPER_PRESET_KEEP) {
+            protopirate_preset_init(
+                app,
+                subghz_setting_get_preset_name(app->setting, preset),
+                frequency,
+                subghz_setting_get_preset_data(app->setting, preset),
+                subghz_setting_get_preset_data_size(app->setting, preset));
+            app->txrx->hopper_preset = preset;
+        }
+    }
+
     // Get preset data
     const char* preset_name = furi_string_get_cstr(app->txrx->preset->name);
     uint8_t* preset_data = subghz_setting_get_preset_data_by_name(app->setting, preset_name);
@@ -167,12 +266,6 @@ void protopirate_scene_receiver_on_enter(void* context) {
     // Begin receiving
     protopirate_begin(app, preset_data);
 
-    uint32_t frequency = app->txrx->preset->frequency;
-    if(app->txrx->hopper_state == ProtoPirateHopperStateRunning) {
-        frequency = subghz_setting_get_hopper_frequency(app->setting, 0);
-        app->txrx->hopper_idx_frequency = 0;
-    }
-
     FURI_LOG_I(TAG, "Starting RX on %lu Hz", frequency);
     protopirate_rx(app, frequency);
     FURI_LOG_I(TAG, "RX started, state: %d", app->txrx->txrx_state);
@@ -193,8 +286,8 @@ bool protopirate_scene_receiver_on_event(void* context, SceneManagerEvent event)
             break;
 
         case ProtoPirateCustomEventViewReceiverOK: {
-            uint16_t idx = protopirate_view_receiver_get_idx_menu(app->protopirate_receiver);
-            FURI_LOG_I(TAG, "Selected item %d", idx);
+            uint32_t idx = protopirate_view_receiver_get_idx_menu(app->protopirate_receiver);
+            FURI_LOG_I(TAG, "Selected item %lu", idx);
             if(idx < protopirate_history_get_item(app->txrx->history)) {
                 app->txrx->idx_menu_chosen = idx;
                 scene_manager_next_scene(app->scene_manager, ProtoPirateSceneReceiverInfo);
@@ -213,7 +306,6 @@ bool protopirate_scene_receiver_on_event(void* context, SceneManagerEvent event)
                 protopirate_rx_end(app);
             }
             protopirate_sleep(app);
-            protopirate_history_reset(app->txrx->history);
             scene_manager_search_and_switch_to_previous_scene(
                 app->scene_manager, ProtoPirateSceneStart);
             consumed = true;
@@ -227,8 +319,9 @@ bool protopirate_scene_receiver_on_event(void* context, SceneManagerEvent event)
         // Update hopper
         if(app->txrx->hopper_state != ProtoPirateHopperStateOFF) {
             protopirate_hopper_update(app);
-            protopirate_scene_receiver_update_statusbar(app);
         }
+        // Cheap when nothing changed; also times out the overrun flag
+        protopirate_scene_receiver_update_statusbar(app);
 
         // Update RSSI from the correct radio device
         if(app->txrx->txrx_state == ProtoPirateTxRxStateRx) {
@@ -260,6 +353,55 @@ void protopirate_scene_receiver_on_exit(void* context) {
     if(app->txrx->txrx_state == ProtoPirateTxRxStateRx) {
         protopirate_rx_end(app);
     }
+
+    // Leave the preset chosen in Receiver Config in place
+    if(app->txrx->hopper_preset != PROTOPIRATE_HOPPER_PRESET_KEEP &&
+       g_home_preset != PROTOPIRATE_HOPPER_PRESET_KEEP) {
+        protopirate_preset_init(
+            app,
+            subghz_setting_get_preset_name(app->setting, g_home_preset),
+            app->txrx->preset->frequency,
+            subghz_setting_get_preset_data(app->setting, g_home_preset),
+            subghz_setting_get_preset_data_size(app->setting, g_home_preset));
+    }
+    app->txrx->hopper_preset = PROTOPIRATE_HOPPER_PRESET_KEEP;
+
+    ProtoPirateHopperLatency latency;
+    protopirate_hopper_get_latency(app->txrx->hopper, &latency);
+    if(latency.hops) {
+        FURI_LOG_I(
+            TAG,
+            "Hop latency over %lu hops: last %luus, avg %luus, max %luus",
+            latency.hops,
+            latency.last_us,
+            latency.avg_us,
+            latency.max_us);
+    }
+
+    ProtoPirateWorkerStats stats;
+    protopirate_worker_get_stats(app->txrx->worker, &stats);
+    FURI_LOG_I(
+        TAG,
+        "Worker: %lu pulses in %lu batches (avg %luus, max %luus), %lu overruns, %lu dropped",
+        stats.pulses,
+        stats.batches,
+        stats.batch_us_avg,
+        stats.batch_us_max,
+        stats.overruns,
+        stats.dropped);
+    if(stats.overruns) {
+        FURI_LOG_I(
+            TAG,
+            "Last overrun %lums ago, %lu decoders reset",
+            furi_get_tick() - stats.overrun_tick,
+            app->txrx->overrun_resets);
+    }
+
+    protopirate_session_log_close(app->session_log);
+
+    furi_string_free(g_frequency_str);
+    furi_string_free(g_modulation_str);
+    furi_string_free(g_history_stat_str);
 }
 
 void protopirate_scene_receiver_view_callback(ProtoPirateCustomEvent event, void* context) {
@@ -1,22 +1,35 @@
 // scenes/protopirate_scene_receiver_config.c
 #include "../protopirate_app_i.h"
+#include "../protocols/protocol_items.h"
 
 enum ProtoPirateSettingIndex {
     ProtoPirateSettingIndexFrequency,
     ProtoPirateSettingIndexHopping,
     ProtoPirateSettingIndexModulation,
     ProtoPirateSettingIndexAutoSave,
+    ProtoPirateSettingIndexSaveMode,
+    ProtoPirateSettingIndexSavePulses,
     ProtoPirateSettingIndexLock,
+    ProtoPirateSettingIndexClearHistory,
+    ProtoPirateSettingIndexProtocolFirst, // One toggle per registry entry from here
 };
 
-#define HOPPING_COUNT 2
+#define HOPPING_COUNT 3
 const char* const hopping_text[HOPPING_COUNT] = {
     "OFF",
     "ON",
+    "AM+FM",
 };
 const uint32_t hopping_value[HOPPING_COUNT] = {
     ProtoPirateHopperStateOFF,
     ProtoPirateHopperStateRunning,
+    ProtoPirateHopperStateRunning,
+};
+// Whether each Hopping option also cycles the modulation preset
+const bool hopping_modulation[HOPPING_COUNT] = {
+    false,
+    false,
+    true,
 };
 
 #define AUTO_SAVE_COUNT 2
@@ -25,6 +38,24 @@ const char* const auto_save_text[AUTO_SAVE_COUNT] = {
     "ON",
 };
 
+#define PROTOCOL_ENABLE_COUNT 2
+const char* const protocol_enable_text[PROTOCOL_ENABLE_COUNT] = {
+    "OFF",
+    "ON",
+};
+
+#define SAVE_PULSES_COUNT 2
+const char* const save_pulses_text[SAVE_PULSES_COUNT] = {
+    "OFF",
+    "ON",
+};
+
+#define SAVE_MODE_COUNT 2
+const char* const save_mode_text[SAVE_MODE_COUNT] = {
+    "Files",
+    "Session",
+};
+
 uint8_t protopirate_scene_receiver_config_next_frequency(const uint32_t value, void* context) {
     furi_assert(context);
     ProtoPirateApp* app = context;
@@ -69,7 +100,7 @@ uint8_t protopirate_scene_receiver_config_hopper_value_index(
             (VariableItem*)scene_manager_get_scene_state(
                 app->scene_manager, ProtoPirateSceneReceiverConfig),
             " -----");
-        return 1;
+        return app->txrx->hopper_modulation ? 2 : 1;
     }
 }
 
@@ -140,6 +171,10 @@ static void protopirate_scene_receiver_config_set_hopping_running(VariableItem*
     }
 
     app->txrx->hopper_state = hopping_value[index];
+    if(app->txrx->hopper_modulation != hopping_modulation[index]) {
+        app->txrx->hopper_modulation = hopping_modulation[index];
+        protopirate_hopper_set_modulation(app->txrx->hopper, hopping_modulation[index]);
+    }
 }
 
 static void protopirate_scene_receiver_config_set_auto_save(VariableItem* item) {
@@ -150,6 +185,38 @@ static void protopirate_scene_receiver_config_set_auto_save(VariableItem* item)
     variable_item_set_current_value_text(item, auto_save_text[index]);
 }
 
+static void protopirate_scene_receiver_config_set_save_mode(VariableItem* item) {
+    ProtoPirateApp* app = variable_item_get_context(item);
+    uint8_t index = variable_item_get_current_value_index(item);
+
+    app->session_mode = (index == 1);
+    variable_item_set_current_value_text(item, save_mode_text[index]);
+}
+
+static void protopirate_scene_receiver_config_set_save_pulses(VariableItem* item) {
+    ProtoPirateApp* app = variable_item_get_context(item);
+    uint8_t index = variable_item_get_current_value_index(item);
+
+    app->save_raw = (index == 1);
+    variable_item_set_current_value_text(item, save_pulses_text[index]);
+}
+
+// Items carry only the app as context, so the protocol is found from the
+// item's position in the list
+static void protopirate_scene_receiver_config_set_protocol(VariableItem* item) {
+    ProtoPirateApp* app = variable_item_get_context(item);
+    uint8_t index = variable_item_get_current_value_index(item);
+    uint8_t protocol = variable_item_list_get_selected_item_index(app->variable_item_list) -
+                       ProtoPirateSettingIndexProtocolFirst;
+
+    if(index) {
+        app->protocols_disabled &= ~(1UL << protocol);
+    } else {
+        app->protocols_disabled |= (1UL << protocol);
+    }
+    variable_item_set_current_value_text(item, protocol_enable_text[index]);
+}
+
 static void
     protopirate_scene_receiver_config_var_list_enter_callback(void* context, uint32_t index) {
     furi_assert(context);
@@ -157,6 +224,9 @@ static void
     if(index == ProtoPirateSettingIndexLock) {
         view_dispatcher_send_custom_event(
             app->view_dispatcher, ProtoPirateCustomEventSceneSettingLock);
+    } else if(index == ProtoPirateSettingIndexClearHistory) {
+        view_dispatcher_send_custom_event(
+            app->view_dispatcher, ProtoPirateCustomEventSceneSettingClearHistory);
     }
 }
 
@@ -218,7 +288,44 @@ void protopirate_scene_receiver_config_on_enter(void* context) {
     variable_item_set_current_value_index(item, app->auto_save ? 1 : 0);
     variable_item_set_current_value_text(item, auto_save_text[app->auto_save ? 1 : 0]);
 
+    // Where auto-save puts captures: one .sub per capture or the session log
+    item = variable_item_list_add(
+        app->variable_item_list,
+        "Save Mode:",
+        SAVE_MODE_COUNT,
+        protopirate_scene_receiver_config_set_save_mode,
+        app);
+    variable_item_set_current_value_index(item, app->session_mode ? 1 : 0);
+    variable_item_set_current_value_text(item, save_mode_text[app->session_mode ? 1 : 0]);
+
+    // Saved .sub files also get the pulses around the capture as RAW_Data
+    item = variable_item_list_add(
+        app->variable_item_list,
+        "Save Pulses:",
+        SAVE_PULSES_COUNT,
+        protopirate_scene_receiver_config_set_save_pulses,
+        app);
+    variable_item_set_current_value_index(item, app->save_raw ? 1 : 0);
+    variable_item_set_current_value_text(item, save_pulses_text[app->save_raw ? 1 : 0]);
+
     variable_item_list_add(app->variable_item_list, "Lock Keyboard", 1, NULL, NULL);
+    // History survives leaving the receiver and restarting the app
+    variable_item_list_add(app->variable_item_list, "Clear History", 1, NULL, NULL);
+
+    // Disabled decoders are skipped by the receiver; applied on returning to it
+    for(size_t i = 0; i < protopirate_protocol_registry.size && i < PROTOPIRATE_DECODERS_MAX;
+        i++) {
+        item = variable_item_list_add(
+            app->variable_item_list,
+            protopirate_protocol_registry.items[i]->name,
+            PROTOCOL_ENABLE_COUNT,
+            protopirate_scene_receiver_config_set_protocol,
+            app);
+        value_index = (app->protocols_disabled & (1UL << i)) ? 0 : 1;
+        variable_item_set_current_value_index(item, value_index);
+        variable_item_set_current_value_text(item, protocol_enable_text[value_index]);
+    }
+
     variable_item_list_set_enter_callback(
         app->variable_item_list, protopirate_scene_receiver_config_var_list_enter_callback, app);
 
@@ -234,6 +341,10 @@ bool protopirate_scene_receiver_config_on_event(void* context, SceneManagerEvent
             app->lock = ProtoPirateLockOn;
             scene_manager_previous_scene(app->scene_manager);
             consumed = true;
+        } else if(event.event == ProtoPirateCustomEventSceneSettingClearHistory) {
+            protopirate_history_reset(app->txrx->history);
+            scene_manager_previous_scene(app->scene_manager);
+            consumed = true;
         }
     }
     return consumed;
@@ -1,6 +1,7 @@
 // scenes/protopirate_scene_receiver_info.c
 #include "../protopirate_app_i.h"
 #include "../helpers/protopirate_storage.h"
+#include "../protocols/protocol_items.h"
 
 static void protopirate_scene_receiver_info_widget_callback(
     GuiButtonType result,
@@ -59,23 +60,27 @@ bool protopirate_scene_receiver_info_on_event(void *context, SceneManagerEvent e
     {
         if (event.event == ProtoPirateCustomEventReceiverInfoSave)
         {
-            // Get the flipper format from history
-            FlipperFormat *ff = protopirate_history_get_raw_data(
-                app->txrx->history, app->txrx->idx_menu_chosen);
+            // Rebuild the capture from history
+            FlipperFormat *ff = flipper_format_string_alloc();
 
-            if (ff)
+            if (protopirate_history_get_raw_data(
+                    app->txrx->history, app->txrx->idx_menu_chosen, ff))
             {
-                // Extract protocol name
-                FuriString *protocol = furi_string_alloc();
-                flipper_format_rewind(ff);
-                if (!flipper_format_read_string(ff, "Protocol", protocol))
+                if (app->save_raw)
                 {
-                    furi_string_set_str(protocol, "Unknown");
+                    protopirate_history_append_raw_data(
+                        app->txrx->history, app->txrx->idx_menu_chosen, ff);
+                }
+                ProtoPirateDecodeResult result;
+                const char *protocol = "Unknown";
+                if (protopirate_history_get_result(
+                        app->txrx->history, app->txrx->idx_menu_chosen, &result))
+                {
+                    protocol = protopirate_protocol_get_name(result.protocol_id);
                 }
 
                 FuriString *saved_path = furi_string_alloc();
-                if (protopirate_storage_save_capture(
-                        ff, furi_string_get_cstr(protocol), saved_path))
+                if (protopirate_storage_save_capture(ff, protocol, saved_path))
                 {
 
                     // Show success notification
@@ -86,9 +91,10 @@ bool protopirate_scene_receiver_info_on_event(void *context, SceneManagerEvent e
                     notification_message(app->notifications, &sequence_error);
                 }
 
-                furi_string_free(protocol);
                 furi_string_free(saved_path);
             }
+
+            flipper_format_free(ff);
             consumed = true;
         }
     }
@@ -1,12 +1,20 @@
 // scenes/protopirate_scene_saved.c
 #include "../protopirate_app_i.h"
 #include "../helpers/protopirate_storage.h"
+#include "../helpers/protopirate_session_log.h"
 
 #define TAG "ProtoPirateSceneSaved"
+#define SAVED_PAGE_SIZE 50
 
+// Capture items use their index in the capture list as event, so the
+// special entries sit at the top of the range.
 typedef enum
 {
-    SubmenuIndexBack = 0xFF,
+    SubmenuIndexFilter = 0xFFFB,
+    SubmenuIndexPrevPage = 0xFFFC,
+    SubmenuIndexNextPage = 0xFFFD,
+    SubmenuIndexExportSession = 0xFFFE,
+    SubmenuIndexBack = 0xFFFF,
 } SavedMenuIndex;
 
 static void protopirate_scene_saved_submenu_callback(void *context, uint32_t index)
@@ -24,14 +32,50 @@ void protopirate_scene_saved_on_enter(void *context)
 
     FURI_LOG_I(TAG, "Entering saved captures scene");
 
+    // Offer to split a pending session log into regular key files
+    uint32_t session_count = protopirate_session_log_get_file_record_count();
+    if (session_count > 0)
+    {
+        char label[32];
+        snprintf(label, sizeof(label), "Export Session (%lu)", session_count);
+        submenu_add_item(
+            app->submenu,
+            label,
+            SubmenuIndexExportSession,
+            protopirate_scene_saved_submenu_callback,
+            app);
+    }
+
+    // The filter is answered from the in-memory capture index
+    protopirate_capture_index_set_filter(&app->capture_filter);
     uint32_t file_count = protopirate_storage_get_file_count();
     FURI_LOG_I(TAG, "File count: %lu", file_count);
 
+    bool filtered = protopirate_capture_filter_is_active(&app->capture_filter);
+    if (filtered || file_count > 0)
+    {
+        char label[32];
+        if (filtered)
+        {
+            snprintf(label, sizeof(label), "Filter (%lu found)", file_count);
+        }
+        else
+        {
+            snprintf(label, sizeof(label), "Filter...");
+        }
+        submenu_add_item(
+            app->submenu,
+            label,
+            SubmenuIndexFilter,
+            protopirate_scene_saved_submenu_callback,
+            app);
+    }
+
     if (file_count == 0)
     {
         submenu_add_item(
             app->submenu,
-            "No saved captures",
+            filtered ? "No matching captures" : "No saved captures",
             SubmenuIndexBack,
             protopirate_scene_saved_submenu_callback,
             app);
@@ -41,7 +85,34 @@ void protopirate_scene_saved_on_enter(void *context)
         FuriString *name = furi_string_alloc();
         FuriString *path = furi_string_alloc();
 
-        for (uint32_t i = 0; i < file_count && i < 50; i++)
+        // Captures are shown a page at a time, newest first
+        uint32_t page_count = (file_count + SAVED_PAGE_SIZE - 1) / SAVED_PAGE_SIZE;
+        uint32_t page = scene_manager_get_scene_state(app->scene_manager, ProtoPirateSceneSaved);
+        if (page >= page_count)
+        {
+            page = page_count - 1;
+            scene_manager_set_scene_state(app->scene_manager, ProtoPirateSceneSaved, page);
+        }
+
+        if (page_count > 1)
+        {
+            char header[32];
+            snprintf(header, sizeof(header), "Saved %lu/%lu", page + 1, page_count);
+            submenu_set_header(app->submenu, header);
+        }
+
+        if (page > 0)
+        {
+            submenu_add_item(
+                app->submenu,
+                "< Newer",
+                SubmenuIndexPrevPage,
+                protopirate_scene_saved_submenu_callback,
+                app);
+        }
+
+        uint32_t first = page * SAVED_PAGE_SIZE;
+        for (uint32_t i = first; i < file_count && i < first + SAVED_PAGE_SIZE; i++)
         {
             if (protopirate_storage_get_file_by_index(i, path, name))
             {
@@ -55,6 +126,16 @@ void protopirate_scene_saved_on_enter(void *context)
             }
         }
 
+        if (page + 1 < page_count)
+        {
+            submenu_add_item(
+                app->submenu,
+                "Older >",
+                SubmenuIndexNextPage,
+                protopirate_scene_saved_submenu_callback,
+                app);
+        }
+
         furi_string_free(name);
         furi_string_free(path);
     }
@@ -74,6 +155,42 @@ bool protopirate_scene_saved_on_event(void *context, SceneManagerEvent event)
             // Just go back
             consumed = true;
         }
+        else if (event.event == SubmenuIndexFilter)
+        {
+            scene_manager_set_scene_state(app->scene_manager, ProtoPirateSceneSaved, 0);
+            scene_manager_next_scene(app->scene_manager, ProtoPirateSceneSavedFilter);
+            consumed = true;
+        }
+        else if (
+            event.event == SubmenuIndexPrevPage || event.event == SubmenuIndexNextPage)
+        {
+            uint32_t page =
+                scene_manager_get_scene_state(app->scene_manager, ProtoPirateSceneSaved);
+            page = (event.event == SubmenuIndexNextPage) ? page + 1 : page - 1;
+            scene_manager_set_scene_state(app->scene_manager, ProtoPirateSceneSaved, page);
+
+            submenu_reset(app->submenu);
+            protopirate_scene_saved_on_enter(app);
+            consumed = true;
+        }
+        else if (event.event == SubmenuIndexExportSession)
+        {
+            uint32_t exported = 0;
+            if (protopirate_session_log_export(&exported))
+            {
+                notification_message(app->notifications, &sequence_success);
+            }
+            else
+            {
+                notification_message(app->notifications, &sequence_error);
+            }
+            FURI_LOG_I(TAG, "Exported %lu captures from session log", exported);
+
+            // Rebuild the list so the new files show up
+            submenu_reset(app->submenu);
+            protopirate_scene_saved_on_enter(app);
+            consumed = true;
+        }
         else
         {
             // Load and display the selected file
@@ -90,6 +207,7 @@ bool protopirate_scene_saved_on_event(void *context, SceneManagerEvent event)
                     furi_string_free(app->loaded_file_path);
                 }
                 app->loaded_file_path = furi_string_alloc_set(path);
+                app->loaded_file_index = event.event;
 
                 scene_manager_next_scene(app->scene_manager, ProtoPirateSceneSavedInfo);
             }
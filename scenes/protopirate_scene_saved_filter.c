@@ -0,0 +1,310 @@
+// scenes/protopirate_scene_saved_filter.c
+#include "../protopirate_app_i.h"
+#include "../helpers/protopirate_storage.h"
+
+#define TAG "ProtoPirateSceneSavedFilter"
+
+// Button choices past "Any", as many as a VariableItem can hold
+#define FILTER_BTN_MAX 254
+
+// Button codes present in the index, plus the current one; row i + 1 is
+// buttons[i]
+static uint8_t buttons[FILTER_BTN_MAX];
+static uint8_t button_count = 0;
+
+// Back from the serial keyboard returns to the filter list, not the browser
+static bool serial_input_active = false;
+
+enum ProtoPirateSavedFilterIndex
+{
+    ProtoPirateSavedFilterIndexProtocol,
+    ProtoPirateSavedFilterIndexButton,
+    ProtoPirateSavedFilterIndexFrequency,
+    ProtoPirateSavedFilterIndexSerial,
+    ProtoPirateSavedFilterIndexClear,
+};
+
+static void protopirate_scene_saved_filter_set_protocol(VariableItem *item)
+{
+    ProtoPirateApp *app = variable_item_get_context(item);
+    uint8_t index = variable_item_get_current_value_index(item);
+
+    if (index == 0)
+    {
+        app->capture_filter.protocol[0] = '\0';
+        variable_item_set_current_value_text(item, "Any");
+    }
+    else
+    {
+        const char *name = protopirate_capture_index_get_protocol_name(index - 1);
+        strncpy(app->capture_filter.protocol, name, sizeof(app->capture_filter.protocol) - 1);
+        app->capture_filter.protocol[sizeof(app->capture_filter.protocol) - 1] = '\0';
+        variable_item_set_current_value_text(item, name);
+    }
+}
+
+static void protopirate_scene_saved_filter_set_button(VariableItem *item)
+{
+    ProtoPirateApp *app = variable_item_get_context(item);
+    uint8_t index = variable_item_get_current_value_index(item);
+
+    if (index == 0)
+    {
+        app->capture_filter.btn = PROTOPIRATE_CAPTURE_FILTER_ANY;
+        variable_item_set_current_value_text(item, "Any");
+    }
+    else
+    {
+        char text_buf[4];
+        app->capture_filter.btn = buttons[index - 1];
+        snprintf(text_buf, sizeof(text_buf), "%02X", app->capture_filter.btn);
+        variable_item_set_current_value_text(item, text_buf);
+    }
+}
+
+static void protopirate_scene_saved_filter_set_frequency(VariableItem *item)
+{
+    ProtoPirateApp *app = variable_item_get_context(item);
+    uint8_t index = variable_item_get_current_value_index(item);
+
+    if (index == 0)
+    {
+        app->capture_filter.frequency = 0;
+        variable_item_set_current_value_text(item, "Any");
+    }
+    else
+    {
+        char text_buf[10];
+        uint32_t frequency = subghz_setting_get_frequency(app->setting, index - 1);
+        app->capture_filter.frequency = frequency;
+        snprintf(
+            text_buf,
+            sizeof(text_buf),
+            "%lu.%02lu",
+            frequency / 1000000,
+            (frequency % 1000000) / 10000);
+        variable_item_set_current_value_text(item, text_buf);
+    }
+}
+
+static void protopirate_scene_saved_filter_enter_callback(void *context, uint32_t index)
+{
+    ProtoPirateApp *app = context;
+    if (index == ProtoPirateSavedFilterIndexSerial)
+    {
+        view_dispatcher_send_custom_event(
+            app->view_dispatcher, ProtoPirateCustomEventSavedFilterSerial);
+    }
+    else if (index == ProtoPirateSavedFilterIndexClear)
+    {
+        view_dispatcher_send_custom_event(
+            app->view_dispatcher, ProtoPirateCustomEventSavedFilterClear);
+    }
+}
+
+static void protopirate_scene_saved_filter_text_input_callback(void *context)
+{
+    ProtoPirateApp *app = context;
+    view_dispatcher_send_custom_event(
+        app->view_dispatcher, ProtoPirateCustomEventSavedFilterSerialDone);
+}
+
+// Accept up to 8 hex digits; anything else clears the serial filter
+static void protopirate_scene_saved_filter_apply_serial(ProtoPirateApp *app)
+{
+    const char *text = app->filter_serial_text;
+    uint32_t prefix = 0;
+    uint8_t len = 0;
+
+    for (; text[len] && len < 8; len++)
+    {
+        char c = text[len];
+        uint8_t digit;
+        if (c >= '0' && c <= '9')
+            digit = c - '0';
+        else if (c >= 'a' && c <= 'f')
+            digit = c - 'a' + 10;
+        else if (c >= 'A' && c <= 'F')
+            digit = c - 'A' + 10;
+        else
+        {
+            len = 0;
+            prefix = 0;
+            break;
+        }
+        prefix = (prefix << 4) | digit;
+    }
+
+    app->capture_filter.serial_prefix = prefix;
+    app->capture_filter.serial_prefix_len = len;
+    if (len == 0)
+    {
+        app->filter_serial_text[0] = '\0';
+    }
+}
+
+void protopirate_scene_saved_filter_on_enter(void *context)
+{
+    ProtoPirateApp *app = context;
+    VariableItem *item;
+    char text_buf[12];
+
+    // Protocol: Any plus every protocol present in the index
+    uint8_t protocol_count = protopirate_capture_index_get_protocol_count();
+    item = variable_item_list_add(
+        app->variable_item_list,
+        "Protocol:",
+        protocol_count + 1,
+        protopirate_scene_saved_filter_set_protocol,
+        app);
+    uint8_t value_index = 0;
+    for (uint8_t i = 0; i < protocol_count; i++)
+    {
+        if (strcmp(protopirate_capture_index_get_protocol_name(i), app->capture_filter.protocol) ==
+            0)
+        {
+            value_index = i + 1;
+            break;
+        }
+    }
+    variable_item_set_current_value_index(item, value_index);
+    protopirate_scene_saved_filter_set_protocol(item);
+
+    // Button: Any plus every code present in the index, and the current one
+    // even if no capture carries it any more
+    button_count = protopirate_capture_index_get_buttons(buttons, FILTER_BTN_MAX);
+    value_index = 0;
+    uint8_t btn = app->capture_filter.btn;
+    if (btn != PROTOPIRATE_CAPTURE_FILTER_ANY)
+    {
+        uint8_t pos = 0;
+        while (pos < button_count && buttons[pos] < btn)
+        {
+            pos++;
+        }
+        if ((pos == button_count || buttons[pos] != btn) && button_count < FILTER_BTN_MAX)
+        {
+            memmove(&buttons[pos + 1], &buttons[pos], button_count - pos);
+            buttons[pos] = btn;
+            button_count++;
+        }
+        if (pos < button_count && buttons[pos] == btn)
+        {
+            value_index = pos + 1;
+        }
+    }
+    item = variable_item_list_add(
+        app->variable_item_list,
+        "Button:",
+        button_count + 1,
+        protopirate_scene_saved_filter_set_button,
+        app);
+    variable_item_set_current_value_index(item, value_index);
+    protopirate_scene_saved_filter_set_button(item);
+
+    uint8_t frequency_count = MIN(subghz_setting_get_frequency_count(app->setting), 254);
+    item = variable_item_list_add(
+        app->variable_item_list,
+        "Frequency:",
+        frequency_count + 1,
+        protopirate_scene_saved_filter_set_frequency,
+        app);
+    value_index = 0;
+    for (uint8_t i = 0; i < frequency_count; i++)
+    {
+        if (subghz_setting_get_frequency(app->setting, i) == app->capture_filter.frequency)
+        {
+            value_index = i + 1;
+            break;
+        }
+    }
+    variable_item_set_current_value_index(item, value_index);
+    protopirate_scene_saved_filter_set_frequency(item);
+
+    item = variable_item_list_add(app->variable_item_list, "Serial Prefix:", 1, NULL, app);
+    if (app->capture_filter.serial_prefix_len > 0)
+    {
+        snprintf(text_buf, sizeof(text_buf), "%s*", app->filter_serial_text);
+        variable_item_set_current_value_text(item, text_buf);
+    }
+    else
+    {
+        variable_item_set_current_value_text(item, "Any");
+    }
+
+    variable_item_list_add(app->variable_item_list, "Clear Filter", 1, NULL, NULL);
+    variable_item_list_set_enter_callback(
+        app->variable_item_list, protopirate_scene_saved_filter_enter_callback, app);
+
+    variable_item_list_set_selected_item(
+        app->variable_item_list,
+        scene_manager_get_scene_state(app->scene_manager, ProtoPirateSceneSavedFilter));
+
+    view_dispatcher_switch_to_view(app->view_dispatcher, ProtoPirateViewVariableItemList);
+}
+
+bool protopirate_scene_saved_filter_on_event(void *context, SceneManagerEvent event)
+{
+    ProtoPirateApp *app = context;
+    bool consumed = false;
+
+    if (event.type == SceneManagerEventTypeCustom)
+    {
+        if (event.event == ProtoPirateCustomEventSavedFilterSerial)
+        {
+            text_input_reset(app->text_input);
+            text_input_set_header_text(app->text_input, "Serial prefix (hex)");
+            text_input_set_result_callback(
+                app->text_input,
+                protopirate_scene_saved_filter_text_input_callback,
+                app,
+                app->filter_serial_text,
+                sizeof(app->filter_serial_text),
+                false);
+            view_dispatcher_switch_to_view(app->view_dispatcher, ProtoPirateViewTextInput);
+            serial_input_active = true;
+            consumed = true;
+        }
+        else if (
+            event.event == ProtoPirateCustomEventSavedFilterSerialDone ||
+            event.event == ProtoPirateCustomEventSavedFilterClear)
+        {
+            serial_input_active = false;
+            if (event.event == ProtoPirateCustomEventSavedFilterClear)
+            {
+                protopirate_capture_filter_reset(&app->capture_filter);
+                app->filter_serial_text[0] = '\0';
+            }
+            else
+            {
+                protopirate_scene_saved_filter_apply_serial(app);
+            }
+
+            // Rebuild the list so every row shows the new values
+            scene_manager_set_scene_state(
+                app->scene_manager,
+                ProtoPirateSceneSavedFilter,
+                variable_item_list_get_selected_item_index(app->variable_item_list));
+            variable_item_list_reset(app->variable_item_list);
+            protopirate_scene_saved_filter_on_enter(app);
+            consumed = true;
+        }
+    }
+    else if (event.type == SceneManagerEventTypeBack && serial_input_active)
+    {
+        serial_input_active = false;
+        view_dispatcher_switch_to_view(app->view_dispatcher, ProtoPirateViewVariableItemList);
+        consumed = true;
+    }
+
+    return consumed;
+}
+
+void protopirate_scene_saved_filter_on_exit(void *context)
+{
+    ProtoPirateApp *app = context;
+    scene_manager_set_scene_state(app->scene_manager, ProtoPirateSceneSavedFilter, 0);
+    variable_item_list_set_selected_item(app->variable_item_list, 0);
+    variable_item_list_reset(app->variable_item_list);
+    text_input_reset(app->text_input);
+}
@@ -1,6 +1,7 @@
 // scenes/protopirate_scene_saved_info.c
 #include "../protopirate_app_i.h"
 #include "../helpers/protopirate_storage.h"
+#include <datetime/datetime.h>
 
 static void protopirate_scene_saved_info_widget_callback(
     GuiButtonType result,
@@ -29,90 +30,79 @@ void protopirate_scene_saved_info_on_enter(void *context)
 
     widget_reset(app->widget);
 
-    if (app->loaded_file_path)
+    // Everything shown here comes from the capture index; the file itself is
+    // only opened when emulating.
+    ProtoPirateCaptureInfo info;
+    if (app->loaded_file_path && protopirate_storage_get_file_info(app->loaded_file_index, &info))
     {
-        FlipperFormat *ff = protopirate_storage_load_file(
-            furi_string_get_cstr(app->loaded_file_path));
+        FuriString *info_str = furi_string_alloc();
 
-        if (ff)
-        {
-            FuriString *info_str = furi_string_alloc();
-            FuriString *temp_str = furi_string_alloc();
-            uint32_t temp_data;
-
-            // Protocol
-            if (flipper_format_read_string(ff, "Protocol", temp_str))
-            {
-                furi_string_cat_printf(info_str, "Protocol: %s\n", furi_string_get_cstr(temp_str));
-            }
+        furi_string_cat_printf(info_str, "Protocol: %s\n", info.protocol);
 
-            // Frequency
-            flipper_format_rewind(ff);
-            if (flipper_format_read_uint32(ff, "Frequency", &temp_data, 1))
-            {
-                furi_string_cat_printf(
-                    info_str, "Freq: %lu.%02lu MHz\n",
-                    temp_data / 1000000, (temp_data % 1000000) / 10000);
-            }
+        if (info.flags & ProtoPirateCaptureInfoFlagFrequency)
+        {
+            furi_string_cat_printf(
+                info_str, "Freq: %lu.%02lu MHz\n",
+                info.frequency / 1000000, (info.frequency % 1000000) / 10000);
+        }
 
-            // Serial
-            flipper_format_rewind(ff);
-            if (flipper_format_read_uint32(ff, "Serial", &temp_data, 1))
-            {
-                furi_string_cat_printf(info_str, "Serial: %08lX\n", temp_data);
-            }
+        if (info.flags & ProtoPirateCaptureInfoFlagSerial)
+        {
+            furi_string_cat_printf(info_str, "Serial: %08lX\n", info.serial);
+        }
 
-            // Button
-            flipper_format_rewind(ff);
-            if (flipper_format_read_uint32(ff, "Btn", &temp_data, 1))
-            {
-                furi_string_cat_printf(info_str, "Button: %02X\n", (uint8_t)temp_data);
-            }
+        if (info.flags & ProtoPirateCaptureInfoFlagBtn)
+        {
+            furi_string_cat_printf(info_str, "Button: %02X\n", info.btn);
+        }
 
-            // Counter
-            flipper_format_rewind(ff);
-            if (flipper_format_read_uint32(ff, "Cnt", &temp_data, 1))
-            {
-                furi_string_cat_printf(info_str, "Counter: %04lX\n", temp_data);
-            }
+        if (info.flags & ProtoPirateCaptureInfoFlagCnt)
+        {
+            furi_string_cat_printf(info_str, "Counter: %04lX\n", info.cnt);
+        }
 
-            // Protocol-specific fields
-            flipper_format_rewind(ff);
-            if (flipper_format_read_uint32(ff, "CRC", &temp_data, 1))
-            {
-                furi_string_cat_printf(info_str, "CRC: %02X\n", (uint8_t)temp_data);
-            }
+        // Protocol-specific fields
+        if (info.flags & ProtoPirateCaptureInfoFlagCrc)
+        {
+            furi_string_cat_printf(info_str, "CRC: %02X\n", info.crc);
+        }
 
-            flipper_format_rewind(ff);
-            if (flipper_format_read_uint32(ff, "Type", &temp_data, 1))
-            {
-                furi_string_cat_printf(info_str, "Type: %02X\n", (uint8_t)temp_data);
-            }
+        if (info.flags & ProtoPirateCaptureInfoFlagType)
+        {
+            furi_string_cat_printf(info_str, "Type: %02X\n", info.type);
+        }
 
-            // Add text to the widget
-            widget_add_text_scroll_element(
-                app->widget, 0, 0, 128, 50,
-                furi_string_get_cstr(info_str));
-
-            // Add buttons
-            widget_add_button_element(
-                app->widget,
-                GuiButtonTypeLeft,
-                "Emulate",
-                protopirate_scene_saved_info_widget_callback,
-                app);
-
-            widget_add_button_element(
-                app->widget,
-                GuiButtonTypeRight,
-                "Delete",
-                protopirate_scene_saved_info_widget_callback,
-                app);
-
-            furi_string_free(temp_str);
-            furi_string_free(info_str);
-            flipper_format_free(ff);
+        if (info.timestamp)
+        {
+            DateTime datetime;
+            datetime_timestamp_to_datetime(info.timestamp, &datetime);
+            furi_string_cat_printf(
+                info_str, "Saved: %04u-%02u-%02u %02u:%02u\n",
+                datetime.year, datetime.month, datetime.day,
+                datetime.hour, datetime.minute);
         }
+
+        // Add text to the widget
+        widget_add_text_scroll_element(
+            app->widget, 0, 0, 128, 50,
+            furi_string_get_cstr(info_str));
+
+        // Add buttons
+        widget_add_button_element(
+            app->widget,
+            GuiButtonTypeLeft,
+            "Emulate",
+            protopirate_scene_saved_info_widget_callback,
+            app);
+
+        widget_add_button_element(
+            app->widget,
+            GuiButtonTypeRight,
+            "Delete",
+            protopirate_scene_saved_info_widget_callback,
+            app);
+
+        furi_string_free(info_str);
     }
 
     view_dispatcher_switch_to_view(app->view_dispatcher, ProtoPirateViewWidget);
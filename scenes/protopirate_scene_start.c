@@ -84,6 +84,8 @@ bool protopirate_scene_start_on_event(void *context, SceneManagerEvent event)
         }
         else if (event.event == SubmenuIndexProtoPirateSaved)
         {
+            // Always open the browser on the newest page
+            scene_manager_set_scene_state(app->scene_manager, ProtoPirateSceneSaved, 0);
             scene_manager_next_scene(app->scene_manager, ProtoPirateSceneSaved);
             consumed = true;
         }
@@ -51,6 +51,7 @@ typedef struct {
     size_t current_protocol_idx;
     void* current_decoder;
     const SubGhzProtocol* current_protocol;
+    uint32_t decoder_mask; // Registry indices worth trying on this file
     bool decode_success;
     
     // Callback context
@@ -434,13 +435,42 @@ static bool protopirate_decode_input_callback(InputEvent* event, void* context)
     return false;
 }
 
+// Modulation the file was recorded with, from its Preset line; both if the
+// preset is unknown or missing
+static SubGhzProtocolFlag
+    protopirate_sub_decode_read_modulation(FlipperFormat* ff, FuriString* temp_str) {
+    SubGhzProtocolFlag modulation = SubGhzProtocolFlag_AM | SubGhzProtocolFlag_FM;
+    if(!flipper_format_read_string(ff, "Preset", temp_str)) {
+        return modulation;
+    }
+
+    if(furi_string_search_str(temp_str, "Ook", 0) != FURI_STRING_FAILURE) {
+        modulation = SubGhzProtocolFlag_AM;
+    } else if(furi_string_search_str(temp_str, "FSK", 0) != FURI_STRING_FAILURE) {
+        modulation = SubGhzProtocolFlag_FM;
+    } else if(furi_string_equal_str(temp_str, "FuriHalSubGhzPresetCustom")) {
+        uint32_t size = 0;
+        if(flipper_format_get_value_count(ff, "Custom_preset_data", &size) && size > 0) {
+            uint8_t* data = malloc(size + 2);
+            memset(data, 0, size + 2); // Terminating pair if the list is cut short
+            if(flipper_format_read_hex(ff, "Custom_preset_data", data, size)) {
+                modulation = protopirate_preset_get_modulation(data);
+            }
+            free(data);
+        }
+    }
+    return modulation;
+}
+
 // Process one chunk of RAW samples
 static bool protopirate_process_raw_chunk(ProtoPirateApp* app, SubDecodeContext* ctx) {
     if(!ctx->current_decoder) {
         while(ctx->current_protocol_idx < protopirate_protocol_registry.size) {
             const SubGhzProtocol* protocol = protopirate_protocol_registry.items[ctx->current_protocol_idx];
+            bool wanted = ctx->current_protocol_idx < 32 &&
+                          (ctx->decoder_mask & (1UL << ctx->current_protocol_idx));
             
-            if(protocol->decoder && protocol->decoder->alloc) {
+            if(wanted && protocol->decoder && protocol->decoder->alloc) {
                 ctx->current_decoder = protocol->decoder->alloc(app->txrx->environment);
                 ctx->current_protocol = protocol;
                 ctx->current_sample = 0;
@@ -703,6 +733,9 @@ bool protopirate_scene_sub_decode_on_event(void* context, SceneManagerEvent even
                 flipper_format_read_header(ctx->ff, temp_str, &version);
                 ctx->frequency = 433920000;
                 flipper_format_read_uint32(ctx->ff, "Frequency", &ctx->frequency, 1);
+                ctx->decoder_mask = protopirate_protocol_get_mask(
+                    protopirate_sub_decode_read_modulation(ctx->ff, temp_str),
+                    app->protocols_disabled);
                 
                 FURI_LOG_I(TAG, "Protocol: %s, Freq: %lu", 
                     furi_string_get_cstr(ctx->protocol_name), ctx->frequency);
@@ -11,12 +11,15 @@
 #define MENU_ITEMS   4u
 #define UNLOCK_CNT   3
 
+// Formatted text of one visible row. Visible rows have consecutive keys, so
+// slot = key % MENU_ITEMS never collides while drawing.
 typedef struct {
-    FuriString* item_str;
-    uint8_t type;
-} ProtoPirateReceiverMenuItem;
-
-ARRAY_DEF(ProtoPirateReceiverMenuItemArray, ProtoPirateReceiverMenuItem, M_POD_OPLIST)
+    FuriString* text; // Already fitted to the row width
+    uint32_t key; // Sequence number in frame mode, fob index in fob mode
+    bool fob;
+    bool scrollbar;
+    bool valid;
+} ProtoPirateReceiverRow;
 
 struct ProtoPirateReceiver {
     View* view;
@@ -25,10 +28,18 @@ struct ProtoPirateReceiver {
 };
 
 typedef struct {
-    ProtoPirateReceiverMenuItemArray_t history_item_arr;
-    uint8_t list_offset;
-    uint8_t history_item;
+    // Rows are read straight from history; only its window is mirrored here
+    ProtoPirateHistory* history;
+    uint32_t item_count;
+    uint32_t first_seq;
+    // Fob mode lists distinct fobs; frame_seq remembers the frame selection
+    bool fob_mode;
+    uint32_t frame_seq;
+    ProtoPirateReceiverRow rows[MENU_ITEMS];
+    uint32_t list_offset;
+    uint32_t history_item;
     float rssi;
+    uint8_t rssi_level;
     FuriString* frequency_str;
     FuriString* preset_str;
     FuriString* history_stat_str;
@@ -38,10 +49,30 @@ typedef struct {
     uint8_t animation_frame;
 } ProtoPirateReceiverModel;
 
+// RSSI as the status bar shows it: 0 idle, 1 activity dot, 2-4 bars
+static uint8_t protopirate_view_receiver_rssi_level(float rssi) {
+    if(rssi >= -60.0f) return 4;
+    if(rssi >= -70.0f) return 3;
+    if(rssi >= -80.0f) return 2;
+    if(rssi > -90.0f) return 1;
+    return 0;
+}
+
 void protopirate_view_receiver_set_rssi(ProtoPirateReceiver* receiver, float rssi) {
     furi_assert(receiver);
+    bool update = false;
     with_view_model(
-        receiver->view, ProtoPirateReceiverModel * model, { model->rssi = rssi; }, true);
+        receiver->view,
+        ProtoPirateReceiverModel * model,
+        {
+            uint8_t level = protopirate_view_receiver_rssi_level(rssi);
+            // Redraw on a visible step, or while something is animating: the
+            // radar on an empty list and the activity pulse above the floor
+            update = (level != model->rssi_level) || (model->item_count == 0) || (level > 0);
+            model->rssi = rssi;
+            model->rssi_level = level;
+        },
+        update);
 }
 
 void protopirate_view_receiver_set_lock(ProtoPirateReceiver* receiver, ProtoPirateLock lock) {
@@ -67,7 +98,7 @@ static void protopirate_view_receiver_update_offset(ProtoPirateReceiver* receive
         {
             size_t history_item = model->history_item;
             size_t list_offset = model->list_offset;
-            size_t item_count = ProtoPirateReceiverMenuItemArray_size(model->history_item_arr);
+            size_t item_count = model->item_count;
 
             if(history_item < list_offset) {
                 model->list_offset = history_item;
@@ -84,19 +115,47 @@ static void protopirate_view_receiver_update_offset(ProtoPirateReceiver* receive
         true);
 }
 
-void protopirate_view_receiver_add_item_to_menu(
+void protopirate_view_receiver_set_history(
     ProtoPirateReceiver* receiver,
-    const char* name,
-    uint8_t type) {
+    ProtoPirateHistory* history) {
+    furi_assert(receiver);
+    with_view_model(
+        receiver->view, ProtoPirateReceiverModel * model, { model->history = history; }, false);
+    protopirate_view_receiver_update_history(receiver);
+}
+
+void protopirate_view_receiver_update_history(ProtoPirateReceiver* receiver) {
     furi_assert(receiver);
     with_view_model(
         receiver->view,
         ProtoPirateReceiverModel * model,
         {
-            ProtoPirateReceiverMenuItem* item_menu =
-                ProtoPirateReceiverMenuItemArray_push_raw(model->history_item_arr);
-            item_menu->item_str = furi_string_alloc_set(name);
-            item_menu->type = type;
+            // Fob rows carry live counters; frame rows never change
+            for(size_t i = 0; i < MENU_ITEMS; i++) {
+                if(model->rows[i].fob) model->rows[i].valid = false;
+            }
+
+            if(model->history && model->fob_mode) {
+                model->first_seq = protopirate_history_get_first_seq(model->history);
+                model->item_count = protopirate_history_get_fob_count(model->history);
+            } else if(model->history) {
+                uint32_t first_seq = protopirate_history_get_first_seq(model->history);
+                uint32_t shift = first_seq - model->first_seq;
+
+                // Keep the selection on the same capture when old ones drop out
+                model->history_item = (shift < model->history_item) ?
+                                          model->history_item - shift :
+                                          0;
+                model->list_offset = (shift < model->list_offset) ?
+                                         model->list_offset - shift :
+                                         0;
+                model->first_seq = first_seq;
+                model->item_count = protopirate_history_get_item(model->history);
+            } else {
+                model->item_count = 0;
+                model->history_item = 0;
+                model->list_offset = 0;
+            }
         },
         true);
     protopirate_view_receiver_update_offset(receiver);
@@ -109,16 +168,29 @@ void protopirate_view_receiver_add_data_statusbar(
     const char* history_stat_str,
     bool external_radio) {
     furi_assert(receiver);
+    bool update = false;
     with_view_model(
         receiver->view,
         ProtoPirateReceiverModel * model,
         {
-            furi_string_set_str(model->frequency_str, frequency_str);
-            furi_string_set_str(model->preset_str, preset_str);
-            furi_string_set_str(model->history_stat_str, history_stat_str);
-            model->external_radio = external_radio;
+            if(!furi_string_equal_str(model->frequency_str, frequency_str)) {
+                furi_string_set_str(model->frequency_str, frequency_str);
+                update = true;
+            }
+            if(!furi_string_equal_str(model->preset_str, preset_str)) {
+                furi_string_set_str(model->preset_str, preset_str);
+                update = true;
+            }
+            if(!furi_string_equal_str(model->history_stat_str, history_stat_str)) {
+                furi_string_set_str(model->history_stat_str, history_stat_str);
+                update = true;
+            }
+            if(model->external_radio != external_radio) {
+                model->external_radio = external_radio;
+                update = true;
+            }
         },
-        true);
+        update);
 }
 
 static void protopirate_view_receiver_draw_frame(Canvas* canvas, uint16_t idx, bool scrollbar) {
@@ -143,7 +215,7 @@ void protopirate_view_receiver_draw(Canvas* canvas, ProtoPirateReceiverModel* mo
     // Increment animation frame
     model->animation_frame = (model->animation_frame + 1) % 96;
 
-    size_t item_count = ProtoPirateReceiverMenuItemArray_size(model->history_item_arr);
+    size_t item_count = model->item_count;
     bool scrollbar = item_count > MENU_ITEMS;
 
     // Draw EXT/INT indicator in upper right corner
@@ -154,20 +226,29 @@ void protopirate_view_receiver_draw(Canvas* canvas, ProtoPirateReceiverModel* mo
         canvas_draw_str_aligned(canvas, 127, 0, AlignRight, AlignTop, "INT");
     }
 
-    FuriString* str_buff;
-    str_buff = furi_string_alloc();
-
     if(item_count > 0) {
         // Draw received items list
         size_t shift_position = model->list_offset;
 
         for(size_t i = 0; i < MIN(item_count, MENU_ITEMS); i++) {
             size_t idx = shift_position + i;
-            ProtoPirateReceiverMenuItem* item =
-                ProtoPirateReceiverMenuItemArray_get(model->history_item_arr, idx);
+            uint32_t key = model->fob_mode ? idx : model->first_seq + idx;
+            ProtoPirateReceiverRow* row = &model->rows[key % MENU_ITEMS];
 
-            furi_string_set(str_buff, item->item_str);
-            elements_string_fit_width(canvas, str_buff, scrollbar ? MAX_LEN_PX - 6 : MAX_LEN_PX);
+            if(!row->valid || row->key != key || row->fob != model->fob_mode ||
+               row->scrollbar != scrollbar) {
+                if(model->fob_mode) {
+                    protopirate_history_get_text_fob_menu(model->history, row->text, idx);
+                } else {
+                    protopirate_history_get_text_item_menu(model->history, row->text, idx);
+                }
+                elements_string_fit_width(
+                    canvas, row->text, scrollbar ? MAX_LEN_PX - 6 : MAX_LEN_PX);
+                row->key = key;
+                row->fob = model->fob_mode;
+                row->scrollbar = scrollbar;
+                row->valid = true;
+            }
 
             if(model->history_item == idx) {
                 protopirate_view_receiver_draw_frame(canvas, i, scrollbar);
@@ -175,7 +256,7 @@ void protopirate_view_receiver_draw(Canvas* canvas, ProtoPirateReceiverModel* mo
                 canvas_set_color(canvas, ColorBlack);
             }
 
-            canvas_draw_str(canvas, 4, 9 + (i * FRAME_HEIGHT), furi_string_get_cstr(str_buff));
+            canvas_draw_str(canvas, 4, 9 + (i * FRAME_HEIGHT), furi_string_get_cstr(row->text));
         }
 
         if(scrollbar) {
@@ -280,8 +361,6 @@ void protopirate_view_receiver_draw(Canvas* canvas, ProtoPirateReceiverModel* mo
         canvas_draw_str(canvas, 2, 45, "< Config");
     }
 
-    furi_string_free(str_buff);
-
     // Status bar separator
     canvas_set_color(canvas, ColorBlack);
     canvas_draw_line(canvas, 0, 48, 127, 48);
@@ -290,7 +369,7 @@ void protopirate_view_receiver_draw(Canvas* canvas, ProtoPirateReceiverModel* mo
     canvas_set_font(canvas, FontSecondary);
     
     // Activity indicator - pulsing when receiving
-    if(model->rssi > -90) {
+    if(model->rssi_level >= 1) {
         int pulse = model->animation_frame % 16;
         if(pulse < 8) {
             canvas_draw_disc(canvas, 2, 54, 1);
@@ -310,15 +389,15 @@ void protopirate_view_receiver_draw(Canvas* canvas, ProtoPirateReceiverModel* mo
     // Draw RSSI indicator with animation
     uint8_t x = 70;
     uint8_t y = 51;
-    float rssi = model->rssi;
+    uint8_t rssi_level = model->rssi_level;
 
-    if(rssi >= -80.0f) {
+    if(rssi_level >= 2) {
         canvas_draw_box(canvas, x, y + 5, 3, 2);
     }
-    if(rssi >= -70.0f) {
+    if(rssi_level >= 3) {
         canvas_draw_box(canvas, x + 4, y + 3, 3, 4);
     }
-    if(rssi >= -60.0f) {
+    if(rssi_level >= 4) {
         canvas_draw_box(canvas, x + 8, y + 1, 3, 6);
         // Pulse effect for strong signal
         if(model->animation_frame % 24 < 12) {
@@ -332,6 +411,45 @@ void protopirate_view_receiver_draw(Canvas* canvas, ProtoPirateReceiverModel* mo
     }
 }
 
+// Switch between the frame and fob lists. Leaving fob mode selects the
+// latest frame of the chosen fob if it is still in history.
+static void protopirate_view_receiver_set_fob_mode(
+    ProtoPirateReceiver* receiver,
+    bool fob_mode,
+    bool select_fob) {
+    with_view_model(
+        receiver->view,
+        ProtoPirateReceiverModel * model,
+        {
+            if(model->history && model->fob_mode != fob_mode) {
+                if(fob_mode) {
+                    model->frame_seq = model->first_seq + model->history_item;
+                    model->history_item = 0;
+                } else {
+                    ProtoPirateHistoryFob fob;
+                    if(select_fob &&
+                       protopirate_history_get_fob(model->history, model->history_item, &fob)) {
+                        model->frame_seq = fob.last_seq;
+                    }
+                    model->first_seq = protopirate_history_get_first_seq(model->history);
+                    model->history_item = (model->frame_seq > model->first_seq) ?
+                                              model->frame_seq - model->first_seq :
+                                              0;
+                }
+                model->fob_mode = fob_mode;
+                model->list_offset = 0;
+                model->item_count = fob_mode ?
+                                        protopirate_history_get_fob_count(model->history) :
+                                        protopirate_history_get_item(model->history);
+                if(model->history_item >= model->item_count) {
+                    model->history_item = model->item_count > 0 ? model->item_count - 1 : 0;
+                }
+            }
+        },
+        true);
+    protopirate_view_receiver_update_offset(receiver);
+}
+
 bool protopirate_view_receiver_input(InputEvent* event, void* context) {
     furi_assert(context);
     ProtoPirateReceiver* receiver = context;
@@ -339,8 +457,15 @@ bool protopirate_view_receiver_input(InputEvent* event, void* context) {
     bool consumed = false;
 
     ProtoPirateLock lock;
+    bool fob_mode = false;
     with_view_model(
-        receiver->view, ProtoPirateReceiverModel * model, { lock = model->lock; }, false);
+        receiver->view,
+        ProtoPirateReceiverModel * model,
+        {
+            lock = model->lock;
+            fob_mode = model->fob_mode;
+        },
+        false);
 
     if(lock == ProtoPirateLockOn) {
         with_view_model(
@@ -383,8 +508,7 @@ bool protopirate_view_receiver_input(InputEvent* event, void* context) {
                 receiver->view,
                 ProtoPirateReceiverModel * model,
                 {
-                    size_t item_count =
-                        ProtoPirateReceiverMenuItemArray_size(model->history_item_arr);
+                    size_t item_count = model->item_count;
                     if(item_count > 0 && model->history_item < item_count - 1) {
                         model->history_item++;
                     }
@@ -400,16 +524,20 @@ bool protopirate_view_receiver_input(InputEvent* event, void* context) {
             consumed = true;
             break;
         case InputKeyRight:
+            protopirate_view_receiver_set_fob_mode(receiver, !fob_mode, false);
             consumed = true;
             break;
         case InputKeyOk:
+            if(fob_mode) {
+                protopirate_view_receiver_set_fob_mode(receiver, false, true);
+                consumed = true;
+                break;
+            }
             with_view_model(
                 receiver->view,
                 ProtoPirateReceiverModel * model,
                 {
-                    size_t item_count =
-                        ProtoPirateReceiverMenuItemArray_size(model->history_item_arr);
-                    if(item_count > 0) {
+                    if(model->item_count > 0) {
                         if(receiver->callback) {
                             receiver->callback(
                                 ProtoPirateCustomEventViewReceiverOK, receiver->context);
@@ -420,23 +548,12 @@ bool protopirate_view_receiver_input(InputEvent* event, void* context) {
             consumed = true;
             break;
         case InputKeyBack:
+            if(fob_mode) {
+                protopirate_view_receiver_set_fob_mode(receiver, false, false);
+                consumed = true;
+                break;
+            }
             if(receiver->callback) {
-                with_view_model(
-                    receiver->view,
-                    ProtoPirateReceiverModel * model,
-                    {
-                        for(size_t i = 0;
-                            i < ProtoPirateReceiverMenuItemArray_size(model->history_item_arr);
-                            i++) {
-                            ProtoPirateReceiverMenuItem* item =
-                                ProtoPirateReceiverMenuItemArray_get(model->history_item_arr, i);
-                            furi_string_free(item->item_str);
-                        }
-                        ProtoPirateReceiverMenuItemArray_reset(model->history_item_arr);
-                        model->history_item = 0;
-                        model->list_offset = 0;
-                    },
-                    false);
                 receiver->callback(ProtoPirateCustomEventViewReceiverBack, receiver->context);
             }
             consumed = true;
@@ -474,13 +591,23 @@ ProtoPirateReceiver* protopirate_view_receiver_alloc() {
         receiver->view,
         ProtoPirateReceiverModel * model,
         {
-            ProtoPirateReceiverMenuItemArray_init(model->history_item_arr);
+            model->history = NULL;
+            model->item_count = 0;
+            model->first_seq = 0;
+            model->fob_mode = false;
+            model->frame_seq = 0;
+            for(size_t i = 0; i < MENU_ITEMS; i++) {
+                model->rows[i].text = furi_string_alloc();
+                model->rows[i].valid = false;
+                model->rows[i].fob = false;
+            }
             model->frequency_str = furi_string_alloc();
             model->preset_str = furi_string_alloc();
             model->history_stat_str = furi_string_alloc();
             model->list_offset = 0;
             model->history_item = 0;
             model->rssi = -127.0f;
+            model->rssi_level = 0;
             model->external_radio = false;
             model->lock = ProtoPirateLockOff;
             model->lock_count = 0;
@@ -498,13 +625,9 @@ void protopirate_view_receiver_free(ProtoPirateReceiver* receiver) {
         receiver->view,
         ProtoPirateReceiverModel * model,
         {
-            for(size_t i = 0; i < ProtoPirateReceiverMenuItemArray_size(model->history_item_arr);
-                i++) {
-                ProtoPirateReceiverMenuItem* item =
-                    ProtoPirateReceiverMenuItemArray_get(model->history_item_arr, i);
-                furi_string_free(item->item_str);
+            for(size_t i = 0; i < MENU_ITEMS; i++) {
+                furi_string_free(model->rows[i].text);
             }
-            ProtoPirateReceiverMenuItemArray_clear(model->history_item_arr);
             furi_string_free(model->frequency_str);
             furi_string_free(model->preset_str);
             furi_string_free(model->history_stat_str);
@@ -520,22 +643,22 @@ View* protopirate_view_receiver_get_view(ProtoPirateReceiver* receiver) {
     return receiver->view;
 }
 
-uint16_t protopirate_view_receiver_get_idx_menu(ProtoPirateReceiver* receiver) {
+uint32_t protopirate_view_receiver_get_idx_menu(ProtoPirateReceiver* receiver) {
     furi_assert(receiver);
-    uint16_t idx = 0;
+    uint32_t idx = 0;
     with_view_model(
         receiver->view, ProtoPirateReceiverModel * model, { idx = model->history_item; }, false);
     return idx;
 }
 
-void protopirate_view_receiver_set_idx_menu(ProtoPirateReceiver* receiver, uint16_t idx) {
+void protopirate_view_receiver_set_idx_menu(ProtoPirateReceiver* receiver, uint32_t idx) {
     furi_assert(receiver);
     with_view_model(
         receiver->view,
         ProtoPirateReceiverModel * model,
         {
             model->history_item = idx;
-            size_t item_count = ProtoPirateReceiverMenuItemArray_size(model->history_item_arr);
+            size_t item_count = model->item_count;
             if(model->history_item >= item_count) {
                 model->history_item = item_count > 0 ? item_count - 1 : 0;
             }
@@ -3,6 +3,7 @@
 
 #include <gui/view.h>
 #include "../helpers/protopirate_types.h"
+#include "../protopirate_history.h"
 
 typedef struct ProtoPirateReceiver ProtoPirateReceiver;
 
@@ -17,10 +18,11 @@ ProtoPirateReceiver* protopirate_view_receiver_alloc(void);
 void protopirate_view_receiver_free(ProtoPirateReceiver* receiver);
 View* protopirate_view_receiver_get_view(ProtoPirateReceiver* receiver);
 
-void protopirate_view_receiver_add_item_to_menu(
+// The list draws rows from history; call update after it changes
+void protopirate_view_receiver_set_history(
     ProtoPirateReceiver* receiver,
-    const char* name,
-    uint8_t type);
+    ProtoPirateHistory* history);
+void protopirate_view_receiver_update_history(ProtoPirateReceiver* receiver);
 
 void protopirate_view_receiver_add_data_statusbar(
     ProtoPirateReceiver* receiver,
@@ -29,7 +31,7 @@ void protopirate_view_receiver_add_data_statusbar(
     const char* history_stat_str,
     bool external_radio);
 
-uint16_t protopirate_view_receiver_get_idx_menu(ProtoPirateReceiver* receiver);
-void protopirate_view_receiver_set_idx_menu(ProtoPirateReceiver* receiver, uint16_t idx);
+uint32_t protopirate_view_receiver_get_idx_menu(ProtoPirateReceiver* receiver);
+void protopirate_view_receiver_set_idx_menu(ProtoPirateReceiver* receiver, uint32_t idx);
 void protopirate_view_receiver_set_rssi(ProtoPirateReceiver* receiver, float rssi);
 void protopirate_view_receiver_set_lock(ProtoPirateReceiver* receiver, ProtoPirateLock lock);